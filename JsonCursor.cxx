@@ -0,0 +1,319 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file  JsonCursor.cxx
+ *  \brief Defines the JsonCursor class.
+ */
+
+#include <JsonCursor.h>
+
+namespace SyscJson
+{
+    using namespace std;
+
+    // =============================================================================
+    // Class JsonCursor
+    // =============================================================================
+    /** \brief Constructor for a cursor at the value at the index argument
+     *
+     *  The second index argument is the key of the value, or zero if the
+     *  value is not an object member.
+     */
+    JsonCursor::JsonCursor(shared_ptr<const JsonTape> arg_doc, size_t arg_idx, size_t arg_kit)
+    {
+        this->doc = arg_doc;
+        this->idx = arg_idx;
+        this->kit = arg_kit;
+    }
+
+    /** \brief Constructor for a cursor that selects no value
+     *
+     */
+    JsonCursor::JsonCursor(void)
+    {
+        this->doc = shared_ptr<const JsonTape>(nullptr);
+        this->idx = 0;
+        this->kit = 0;
+    }
+
+    /** \brief Destructor for JsonCursor
+     *
+     *   No-op.
+     */
+    JsonCursor::~JsonCursor(void) { }
+
+    /** \brief Check for a cursor that selects no value
+     *
+     */
+    bool
+    JsonCursor::is_none(void) const
+    {
+        return this->doc == nullptr;
+    }
+
+    /** \brief Check for a JSON object at the cursor
+     *
+     */
+    bool
+    JsonCursor::is_obj(void) const
+    {
+        return (!this->is_none()) && (this->doc->get_styp(this->idx) == json_styp_obj_bgn);
+    }
+
+    /** \brief Check for a JSON array at the cursor
+     *
+     */
+    bool
+    JsonCursor::is_arr(void) const
+    {
+        return (!this->is_none()) && (this->doc->get_styp(this->idx) == json_styp_arr_bgn);
+    }
+
+    /** \brief Check for a JSON string at the cursor
+     *
+     */
+    bool
+    JsonCursor::is_str(void) const
+    {
+        if (this->is_none()) return false;
+        if (this->doc->get_styp(this->idx) != json_styp_elem) return false;
+        if (this->doc->get_etyp(this->idx) != json_etyp_str) return false;
+        return true;
+    }
+
+    /** \brief Check for a JSON number at the cursor
+     *
+     */
+    bool
+    JsonCursor::is_num(void) const
+    {
+        if (this->is_none()) return false;
+        if (this->doc->get_styp(this->idx) != json_styp_elem) return false;
+        if (this->doc->get_etyp(this->idx) != json_etyp_num) return false;
+        return true;
+    }
+
+    /** \brief Check for JSON null at the cursor
+     *
+     */
+    bool
+    JsonCursor::is_nul(void) const
+    {
+        if (this->is_none()) return false;
+        if (this->doc->get_styp(this->idx) != json_styp_elem) return false;
+        if (this->doc->get_etyp(this->idx) != json_etyp_nul) return false;
+        return true;
+    }
+
+    /** \brief Check for JSON true at the cursor
+     *
+     */
+    bool
+    JsonCursor::is_tru(void) const
+    {
+        if (this->is_none()) return false;
+        if (this->doc->get_styp(this->idx) != json_styp_elem) return false;
+        if (this->doc->get_etyp(this->idx) != json_etyp_tru) return false;
+        return true;
+    }
+
+    /** \brief Check for JSON false at the cursor
+     *
+     */
+    bool
+    JsonCursor::is_fal(void) const
+    {
+        if (this->is_none()) return false;
+        if (this->doc->get_styp(this->idx) != json_styp_elem) return false;
+        if (this->doc->get_etyp(this->idx) != json_etyp_fal) return false;
+        return true;
+    }
+
+    /** \brief Check for an object member at the cursor
+     *
+     */
+    bool
+    JsonCursor::has_key(void) const
+    {
+        return (!this->is_none()) && (this->kit != 0);
+    }
+
+    /** \brief Get the key of the object member at the cursor
+     *
+     *  The string is set to the key, or cleared if the cursor is not at
+     *  an object member.
+     */
+    void
+    JsonCursor::get_key(string & arg_str) const
+    {
+        if (!this->has_key())
+        {
+            arg_str.clear();
+            return;
+        }
+
+        arg_str.assign(this->doc->get_ptr(this->kit), this->doc->get_len(this->kit));
+    }
+
+    /** \brief Get the token at the cursor
+     *
+     *  The token is cleared if the cursor selects no value.
+     */
+    void
+    JsonCursor::get_token(Token & arg_tok) const
+    {
+        if (this->is_none())
+        {
+            arg_tok = Token();
+            return;
+        }
+
+        this->doc->get_token(this->idx, arg_tok);
+    }
+
+    /** \brief Get the string representation of the value at the cursor
+     *
+     *  As JsonFind::get_context_string().
+     */
+    void
+    JsonCursor::get_string(string & arg_str) const
+    {
+        if (this->is_none())
+        {
+            arg_str.clear();
+            return;
+        }
+
+        this->doc->get_string(this->idx, arg_str);
+    }
+
+    /** \brief Get the JSON source text of the value at the cursor
+     *
+     *  As JsonFind::get_context_view().
+     */
+    bool
+    JsonCursor::get_view(const char * & arg_ptr, size_t & arg_len) const
+    {
+        if (this->is_none())
+        {
+            return false;
+        }
+
+        return this->doc->get_view(this->idx, arg_ptr, arg_len);
+    }
+
+    /** \brief Cursor at the first item of the object or array at the
+     *         cursor
+     *
+     *  The cursor selects no value if the object or array is empty, or
+     *  if there is no object or array at the cursor.
+     */
+    JsonCursor
+    JsonCursor::get_child(void) const
+    {
+        size_t cit;
+
+        if ((!this->is_obj()) && (!this->is_arr()))
+        {
+            return JsonCursor();
+        }
+
+        cit = this->doc->next(this->idx);
+
+        switch (this->doc->get_styp(cit))
+        {
+            case json_styp_key     : return JsonCursor(this->doc, this->doc->next(cit), cit);
+            case json_styp_obj_end : return JsonCursor();
+            case json_styp_arr_end : return JsonCursor();
+            default                : return JsonCursor(this->doc, cit, 0);
+        }
+    }
+
+    /** \brief Cursor at the next item of the object or array holding the
+     *         value at the cursor
+     *
+     *  The cursor selects no value after the last item, or for the
+     *  top-level object or array.
+     */
+    JsonCursor
+    JsonCursor::get_next(void) const
+    {
+        size_t nit;
+
+        if ((this->is_none()) || (this->idx == 0))
+        {
+            return JsonCursor();
+        }
+
+        nit = this->doc->skip(this->idx);
+
+        switch (this->doc->get_styp(nit))
+        {
+            case json_styp_key     : return JsonCursor(this->doc, this->doc->next(nit), nit);
+            case json_styp_obj_end : return JsonCursor();
+            case json_styp_arr_end : return JsonCursor();
+            default                : return JsonCursor(this->doc, nit, 0);
+        }
+    }
+
+    /** \brief Cursor at the object or array holding the value at the
+     *         cursor
+     *
+     *  The cursor selects no value for the top-level object or array.
+     *  The search context is descended from the top level, stepping over
+     *  the values preceding the cursor at each level.
+     */
+    JsonCursor
+    JsonCursor::get_parent(void) const
+    {
+        size_t pit;
+        size_t pkit;
+
+        if ((this->is_none()) || (this->idx == 0))
+        {
+            return JsonCursor();
+        }
+
+        pit = this->doc->get_parent(this->idx, pkit);
+
+        return JsonCursor(this->doc, pit, pkit);
+    }
+
+    /** \brief Search for a JSON value from the cursor
+     *
+     *  The search path argument is resolved with the value at the cursor
+     *  in place of the top-level object or array, as by
+     *  JsonFind::find(const JsonPath&).  Returns a cursor at the value
+     *  found, which for a path selecting a key is the key's value.  The
+     *  cursor selects no value if the search is unsuccessful.
+     */
+    JsonCursor
+    JsonCursor::find(const JsonPath & arg_path) const
+    {
+        size_t dit = this->idx;
+        size_t kit = this->kit;
+
+        if ((this->is_none()) || (!arg_path.resolve(*(this->doc), dit, kit, 0)))
+        {
+            return JsonCursor();
+        }
+
+        return JsonCursor(this->doc, dit, kit);
+    }
+}
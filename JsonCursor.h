@@ -0,0 +1,96 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file  JsonCursor.h
+ *  \brief Declares the JsonCursor class.
+ */
+
+#ifndef _JSON_CURSOR_H_
+    #define _JSON_CURSOR_H_
+
+    #include <memory>
+    #include <string>
+    #include <JsonToken.h>
+    #include <JsonTape.h>
+    #include <JsonPath.h>
+
+    namespace SyscJson
+    {
+        using std::shared_ptr;
+        using std::string;
+        using std::size_t;
+
+        /** \class JsonCursor
+         *  \brief Position of a value within a parsed search context
+         *
+         *  A cursor is returned by JsonFind::get_cursor() or
+         *  JsonFind::get_root(), and holds the search context it was taken
+         *  from and the index of a value in it.  Copying a cursor copies
+         *  only the two.
+         *
+         *  <h2 class="mp">Methods</h2>
+         *
+         *  The get_child(), get_next() and get_parent() methods return
+         *  cursors at the first item of an object or array, at the next
+         *  item of the same object or array, and at the object or array
+         *  holding the value.  For object members, the cursor is at the
+         *  value, and get_key() gives its key.
+         *
+         *  The find() method resolves a JsonPath from the cursor, as
+         *  JsonFind::find() does from the top level of the search context.
+         *
+         *  None of the methods parse JSON.  A cursor that does not select
+         *  a value is reported by is_none().
+         */
+        class JsonCursor
+        {
+            friend class JsonFind;
+            friend class JsonDoc;
+
+            private:
+            shared_ptr<const JsonTape> doc;
+            size_t                     idx;
+            size_t                     kit;
+
+            JsonCursor(shared_ptr<const JsonTape>, size_t, size_t);
+
+            public:
+            JsonCursor(void);
+            ~JsonCursor(void);
+
+            bool       is_none    ( void                  ) const;
+            bool       is_obj     ( void                  ) const;
+            bool       is_arr     ( void                  ) const;
+            bool       is_str     ( void                  ) const;
+            bool       is_num     ( void                  ) const;
+            bool       is_nul     ( void                  ) const;
+            bool       is_tru     ( void                  ) const;
+            bool       is_fal     ( void                  ) const;
+            bool       has_key    ( void                  ) const;
+            void       get_key    ( string&               ) const;
+            void       get_token  ( Token&                ) const;
+            void       get_string ( string&               ) const;
+            bool       get_view   ( const char*&, size_t& ) const;
+            JsonCursor get_child  ( void                  ) const;
+            JsonCursor get_next   ( void                  ) const;
+            JsonCursor get_parent ( void                  ) const;
+            JsonCursor find       ( const JsonPath&       ) const;
+        };
+    }
+#endif
@@ -0,0 +1,269 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file  JsonDoc.cxx
+ *  \brief Defines the JsonDoc and JsonDocErr classes.
+ */
+
+#include <JsonVec.h>
+#include <JsonDoc.h>
+
+namespace SyscJson
+{
+    using namespace std;
+    using namespace SyscMsg;
+    using namespace SyscMsg::Chars;
+    using namespace JsonParse;
+
+    // =============================================================================
+    // Class JsonDocErr
+    // =============================================================================
+    /** \brief Constructor for JsonDocErr exception class
+     *
+     *  Argument string may be used to describe the exception.
+     *
+     */
+    JsonDocErr::JsonDocErr(string s)
+    {
+        this->err_msg = s;
+    }
+
+    /** \brief Destructor for JsonDocErr exception class
+     *
+     *  No-op.
+     *
+     */
+    JsonDocErr::~JsonDocErr(void)
+    {
+    }
+
+    /** \brief Accessor method for JsonDocErr exception message
+     *
+     *  Returns the message string.
+     *
+     */
+    string
+    JsonDocErr::get_msg(void)
+    {
+        return "JsonDocErr reports" + SP + this->err_msg;
+    }
+
+    // =============================================================================
+    // Class JsonDoc
+    // =============================================================================
+    /** \brief Constructor for JsonDoc debug instance
+     *
+     *  The string parameter specifies that debug messages are desired,
+     *  and is used to prefix all debug messages.  The document is empty
+     *  until parse() or parse_file() is called.
+     */
+    JsonDoc::JsonDoc(const string & arg_msgid)
+    {
+        this->msg        = unique_ptr<Msg>(new Msg(arg_msgid.c_str()));
+        this->tape       = make_shared<JsonTape>();
+        this->engine     = json_engn_flex;
+        this->token_mode = json_tmod_copy;
+        this->key_index  = 0;
+        this->elem_index = 0;
+    }
+
+    /** \brief Constructor for JsonDoc non-debug instance
+     *
+     *  The document is empty until parse() or parse_file() is called.
+     */
+    JsonDoc::JsonDoc(void)
+    {
+        this->msg        = unique_ptr<Msg>(nullptr);
+        this->tape       = make_shared<JsonTape>();
+        this->engine     = json_engn_flex;
+        this->token_mode = json_tmod_copy;
+        this->key_index  = 0;
+        this->elem_index = 0;
+    }
+
+    /** \brief Destructor for JsonDoc
+     *
+     *   No-op.
+     */
+    JsonDoc::~JsonDoc(void) { }
+
+    /* Parse into a new tape and build its indexes, so that searches
+     * never modify it.  Searches holding the previous tape keep it.
+     */
+    void
+    JsonDoc::parse(shared_ptr<const JsonSrc> arg_src)
+    {
+        unique_ptr<JsonVec>  jv;
+        unique_ptr<JsonTape> tmp;
+
+        try
+        {
+            if (this->msg == nullptr)
+            {
+                jv = unique_ptr<JsonVec>(new JsonVec(arg_src, this->engine, this->token_mode));
+            }
+            else
+            {
+                jv = unique_ptr<JsonVec>(new JsonVec(arg_src, this->msg->get_str_r_msgid() + "JsonVec parse:", this->engine, this->token_mode));
+            }
+        }
+        catch (JsonVecErr & err)
+        {
+            if (this->msg != nullptr) { this->msg->cerr_err(err.get_msg()); }
+
+            throw JsonDocErr("failure in JsonDoc::parse():" + SP + err.get_msg());
+        }
+
+        jv->swap_tape(tmp);
+
+        this->put_tape(shared_ptr<JsonTape>(move(tmp)));
+    }
+
+    /* Build the indexes of a tape no search holds yet and make it the
+     * document.  Searches holding the previous tape keep it.
+     */
+    void
+    JsonDoc::put_tape(shared_ptr<JsonTape> arg_tape)
+    {
+        arg_tape->set_key_index(this->key_index);
+        arg_tape->build_key_index();
+        arg_tape->set_elem_index(this->elem_index);
+        arg_tape->build_elem_index();
+
+        this->tape = arg_tape;
+    }
+
+    /** \brief Select the parser engine
+     *
+     *  Selects the engine used by later calls to parse() and
+     *  parse_file().  The default is json_engn_flex.
+     */
+    void
+    JsonDoc::set_engine(JsonEngines arg_engn)
+    {
+        this->engine = arg_engn;
+    }
+
+    /** \brief Select the token string mode
+     *
+     *  Selects the mode used by later calls to parse() and parse_file(),
+     *  as JsonFind::set_token_mode().  The default is json_tmod_copy.
+     */
+    void
+    JsonDoc::set_token_mode(JsonTokenModes arg_tmod)
+    {
+        this->token_mode = arg_tmod;
+    }
+
+    /** \brief Index objects with at least the argument number of keys
+     *
+     *  As JsonFind::build_key_index().  Zero, the default, disables
+     *  indexing.  The indexes of a parsed document are built immediately,
+     *  in a copy of the document, so searches already holding it are
+     *  not disturbed and keep the indexes they had.
+     */
+    void
+    JsonDoc::set_key_index(size_t arg_min)
+    {
+        this->key_index = arg_min;
+        this->put_tape(make_shared<JsonTape>(*(this->tape)));
+    }
+
+    /** \brief Index arrays with at least the argument number of items
+     *
+     *  As JsonFind::build_elem_index().  Zero, the default, disables
+     *  indexing.  The indexes of a parsed document are built immediately,
+     *  in a copy of the document, so searches already holding it are
+     *  not disturbed and keep the indexes they had.
+     */
+    void
+    JsonDoc::set_elem_index(size_t arg_min)
+    {
+        this->elem_index = arg_min;
+        this->put_tape(make_shared<JsonTape>(*(this->tape)));
+    }
+
+    /** \brief Load the document from a JSON string
+     *
+     *  Throws JsonDocErr if the string argument is not valid JSON.
+     */
+    void
+    JsonDoc::parse(const string & arg_str)
+    {
+        this->parse(make_shared<const JsonSrc>(arg_str));
+    }
+
+    /** \brief Load the document from a JSON file
+     *
+     *  The file named by the string argument is mapped read-only and
+     *  parsed in place, as by JsonFind::set_search_context_file().
+     *  Throws JsonDocErr if the file cannot be read or is not valid JSON.
+     */
+    void
+    JsonDoc::parse_file(const string & arg_path)
+    {
+        shared_ptr<JsonSrc> src = make_shared<JsonSrc>();
+
+        try
+        {
+            src->set_file(arg_path);
+        }
+        catch (JsonSrcErr & err)
+        {
+            if (this->msg != nullptr) { this->msg->cerr_err(err.get_msg()); }
+
+            throw JsonDocErr("failure in JsonDoc::parse_file():" + SP + err.get_msg());
+        }
+
+        this->parse(src);
+    }
+
+    /** \brief True until a document is parsed
+     *
+     */
+    bool
+    JsonDoc::empty(void) const
+    {
+        return this->tape->empty();
+    }
+
+    /** \brief The parsed document
+     *
+     */
+    shared_ptr<const JsonTape>
+    JsonDoc::get_tape(void) const
+    {
+        return this->tape;
+    }
+
+    /** \brief Get a cursor at the top-level object or array
+     *
+     *  The cursor selects no value for an empty document.
+     */
+    JsonCursor
+    JsonDoc::get_root(void) const
+    {
+        if (this->tape->empty())
+        {
+            return JsonCursor();
+        }
+
+        return JsonCursor(this->tape, 0, 0);
+    }
+}
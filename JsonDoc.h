@@ -0,0 +1,128 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file  JsonDoc.h
+ *  \brief Declares the JsonDoc and JsonDocErr classes.
+ */
+
+#ifndef _JSON_DOC_H_
+    #define _JSON_DOC_H_
+
+    #include <memory>
+    #include <string>
+    #include <SyscMsg.h>
+    #include <JsonToken.h>
+    #include <JsonTape.h>
+    #include <JsonCursor.h>
+
+    namespace JsonParse
+    {
+        class JsonSrc;
+    }
+
+    namespace SyscJson
+    {
+        using SyscMsg::Msg;
+        using std::unique_ptr;
+        using std::shared_ptr;
+        using std::string;
+        using std::size_t;
+
+        /** \class JsonDocErr
+         *  \brief Exception class for JsonDoc
+         *
+         *  This class is thrown by the JsonDoc::parse() and
+         *  JsonDoc::parse_file() methods in the event of a JSON parsing
+         *  or file error.
+         *
+         *  The err_msg string is set in the constructor and may be
+         *  used to indicate why the exception was thrown.  It is
+         *  accessed by the get_msg() method.
+         */
+        /** \var   JsonDocErr::err_msg
+         *  \brief String data for exception message
+         */
+        class JsonDocErr
+        {
+            public:
+            string err_msg;
+
+            JsonDocErr(string);
+            ~JsonDocErr(void);
+
+            string get_msg(void);
+        };
+
+        /** \class JsonDoc
+         *  \brief Parsed JSON for sharing between searches
+         *
+         *  <h2 class="mp">Methods</h2>
+         *
+         *  The parse() and parse_file() methods load the document from a
+         *  JSON string or file, using the parser engine and token mode
+         *  selected by set_engine() and set_token_mode().
+         *
+         *  The set_key_index() and set_elem_index() methods select the
+         *  objects and arrays given indexes, as for JsonFind.  The indexes
+         *  are built when the document is parsed, or immediately in a copy
+         *  of a document already parsed, never on first use.  Searches
+         *  already holding the document keep the copy they had.
+         *
+         *  The get_root() method returns a JsonCursor at the top-level
+         *  object or array.
+         *
+         *  <h2 class="mp">Threads</h2>
+         *
+         *  The document is changed only by its non-const methods.  Once
+         *  it is loaded and held as a shared_ptr<const JsonDoc>, any number
+         *  of JsonFind instances, each holding its own search path and
+         *  context token, and any number of cursors may search it
+         *  concurrently from different threads, without copying it.  See
+         *  JsonFind::set_search_context(shared_ptr<const JsonDoc>).
+         */
+        class JsonDoc
+        {
+            private:
+            unique_ptr<Msg>      msg;
+            shared_ptr<JsonTape> tape;
+            JsonEngines          engine;
+            JsonTokenModes       token_mode;
+            size_t               key_index;
+            size_t               elem_index;
+
+            void parse    ( shared_ptr<const JsonParse::JsonSrc> );
+            void put_tape ( shared_ptr<JsonTape>                 );
+
+            public:
+            JsonDoc(const string&);
+            JsonDoc(void);
+            ~JsonDoc(void);
+
+            void                       set_engine     ( JsonEngines    );
+            void                       set_token_mode ( JsonTokenModes );
+            void                       set_key_index  ( size_t         );
+            void                       set_elem_index ( size_t         );
+            void                       parse          ( const string&  );
+            void                       parse_file     ( const string&  );
+            bool                       empty          ( void           ) const;
+            shared_ptr<const JsonTape> get_tape       ( void           ) const;
+            JsonCursor                 get_root       ( void           ) const;
+        };
+    }
+#endif
@@ -23,7 +23,10 @@
 
 #include <cctype>
 #include <JsonVec.h>
-#include <JsonStr.h>
+#include <JsonScan.h>
+#include <JsonNum.h>
+#include <JsonTrie.h>
+#include <JsonPush.h>
 #include <JsonFind.h>
 
 namespace SyscJson
@@ -33,6 +36,61 @@ namespace SyscJson
     using namespace SyscMsg::Chars;
     using namespace JsonParse;
 
+    /* Converts the number items of the array at the index argument,
+     * appending them to the vector, and returns the index of the first
+     * item that does not convert, with its status, or the item count
+     */
+    template <typename T, typename C>
+    static size_t
+    get_items(const JsonTape & tape, size_t idx, vector<T> & arg_vec, C conv, JsonNumStats & arg_stat)
+    {
+        size_t end = tape.get_match(idx);
+        size_t cnt = 0;
+
+        arg_vec.clear();
+        arg_vec.reserve((end - idx) / 2);
+        arg_stat = json_num_ok;
+
+        for (size_t i = tape.next(idx) ; i != end ; i = tape.skip(i), cnt++)
+        {
+            T val;
+
+            if ((tape.get_styp(i) != json_styp_elem) || (tape.get_etyp(i) != json_etyp_num))
+            {
+                arg_stat = json_num_type;
+                return cnt;
+            }
+
+            arg_stat = conv(tape.get_ptr(i), tape.get_len(i), val);
+
+            if (arg_stat != json_num_ok)
+            {
+                return cnt;
+            }
+
+            arg_vec.push_back(val);
+        }
+
+        return cnt;
+    }
+
+    /* Converts a number to a byte */
+    static JsonNumStats
+    get_byte(const char * arg_ptr, size_t arg_len, uint8_t & arg_val)
+    {
+        uint64_t     val;
+        JsonNumStats stat = json_get_uint64(arg_ptr, arg_len, val);
+
+        if ((stat == json_num_ok) && (val > 255))
+        {
+            stat = json_num_range;
+        }
+
+        arg_val = static_cast<uint8_t>(val);
+
+        return stat;
+    }
+
     // =============================================================================
     // Class JsonFindErr
     // =============================================================================
@@ -81,9 +139,14 @@ namespace SyscJson
     JsonFind::JsonFind(const string & arg_msgid)
     {
         this->msg            = unique_ptr<Msg>(new Msg(arg_msgid.c_str()));
-        this->search_context = unique_ptr<Tokens>(nullptr);
-        this->search_path    = unique_ptr<Tokens>(nullptr);
-        this->context_token  = unique_ptr<Token>(nullptr);
+        this->search_context = shared_ptr<const JsonTape>(nullptr);
+        this->own_context    = shared_ptr<JsonTape>(nullptr);
+        this->search_path    = unique_ptr<JsonPath>(nullptr);
+        this->context_set    = false;
+        this->engine         = json_engn_flex;
+        this->token_mode     = json_tmod_copy;
+        this->key_index      = 0;
+        this->elem_index     = 0;
     }
 
     /** \brief Constructor for JsonFind non-debug instance
@@ -95,9 +158,14 @@ namespace SyscJson
     JsonFind::JsonFind(void)
     {
         this->msg            = unique_ptr<Msg>(nullptr);
-        this->search_context = unique_ptr<Tokens>(nullptr);
-        this->search_path    = unique_ptr<Tokens>(nullptr);
-        this->context_token  = unique_ptr<Token>(nullptr);
+        this->search_context = shared_ptr<const JsonTape>(nullptr);
+        this->own_context    = shared_ptr<JsonTape>(nullptr);
+        this->search_path    = unique_ptr<JsonPath>(nullptr);
+        this->context_set    = false;
+        this->engine         = json_engn_flex;
+        this->token_mode     = json_tmod_copy;
+        this->key_index      = 0;
+        this->elem_index     = 0;
     }
 
     /** \brief Destructor for JsonFind
@@ -106,25 +174,34 @@ namespace SyscJson
      */
     JsonFind::~JsonFind(void) { }
 
-    /** \brief Parse a JSON string
+    /** \brief Parse a JSON source
      *
-     *  The token vector is loaded with tokens
-     *  parsed from a JSON string argument.
+     *  The tape is loaded with tokens parsed from the JSON source argument.
+     *  For json_tmod_view, the tape retains the source.
      */
     void
-    JsonFind::parse(Tokens & arg_tok, string & arg_str)
+    JsonFind::parse(shared_ptr<JsonTape> & arg_tape, shared_ptr<const JsonSrc> arg_src, JsonTokenModes arg_tmod)
     {
-        unique_ptr<JsonVec> jv;
+        unique_ptr<JsonVec>  jv;
+        unique_ptr<JsonTape> tape;
 
         try
         {
-            if (this->msg == nullptr)
+            if ((this->msg == nullptr) && (this->projection.empty()))
+            {
+                jv = unique_ptr<JsonVec>(new JsonVec(arg_src, this->engine, arg_tmod));
+            }
+            else if (this->msg == nullptr)
             {
-                jv = unique_ptr<JsonVec>(new JsonVec(arg_str));
+                jv = unique_ptr<JsonVec>(new JsonVec(arg_src, this->engine, arg_tmod, this->projection));
+            }
+            else if (this->projection.empty())
+            {
+                jv = unique_ptr<JsonVec>(new JsonVec(arg_src, this->msg->get_str_r_msgid() + "JsonVec parse:", this->engine, arg_tmod));
             }
             else
             {
-                jv = unique_ptr<JsonVec>(new JsonVec(arg_str, this->msg->get_str_r_msgid() + "JsonVec parse:"));
+                jv = unique_ptr<JsonVec>(new JsonVec(arg_src, this->msg->get_str_r_msgid() + "JsonVec parse:", this->engine, arg_tmod, this->projection));
             }
         }
         catch (JsonVecErr & err)
@@ -135,148 +212,228 @@ namespace SyscJson
             throw JsonFindErr("failure in JsonFind::parse():" + SP + err.get_msg());
         }
 
-        arg_tok.swap(jv->get_tokens());
+        jv->swap_tape(tape);
+        arg_tape = move(tape);
     }
 
-    /** \brief Return the number of tokens in the value or [key:value] pair
-     *
-     *  Return
-     *  * 0 for non-array, non-object value
-     *  * 1 for key associated with non-array, non-object value
-     *  * N for array, object or key associated with array or object value
+    /** \brief Parse a JSON string up to the end of a search
      *
-     *  Procedure
-     *  1. Determine what is to be done
-     *  ** Object: set up a search for end token
-     *  ** Array: set up a search for end token
-     *  ** Key
-     *  *** For key with non-array, non-object value, return 1
-     *  *** For key with an array or object, set up a search for end token
-     *  ** Non-array, non-object value, return 0
-     *  2. Search for end token
-     *  3. Return distance from context token to end token
+     *  The JSON string argument is parsed only as far as the end of the
+     *  value selected by the search path, which alone is kept as the
+     *  search context.  For a path selecting a key, the search context is
+     *  an object holding only that key and its value.
      */
-    ptrdiff_t
-    JsonFind::get_dist(void)
+    void
+    JsonFind::stream(const char * arg_ptr, size_t arg_len)
     {
-        TokenI          dit = this->search_context_iter;
-        int             sstk;
-        JsonStructTypes styp_bgn;
-        JsonStructTypes styp_end;
+        unique_ptr<JsonPush> push;
+        unique_ptr<JsonTape> tape;
+        bool                 sel;
+
+        this->clr_context();
+        this->own_context    = make_shared<JsonTape>();
+        this->search_context = this->own_context;
 
-        // initial
-        switch (dit->struct_type)
+        if (this->search_path == nullptr)
         {
-            case json_styp_obj_bgn :
-            {
-                styp_bgn = json_styp_obj_bgn;
-                styp_end = json_styp_obj_end;
-                sstk     = 0;
+            return;
+        }
 
-                break;
-            }
-            case json_styp_arr_bgn :
-            {
-                styp_bgn = json_styp_arr_bgn;
-                styp_end = json_styp_arr_end;
-                sstk     = 0;
+        if (this->msg == nullptr)
+        {
+            push = unique_ptr<JsonPush>(new JsonPush());
+        }
+        else
+        {
+            push = unique_ptr<JsonPush>(new JsonPush(this->msg->get_str_r_msgid() + "JsonPush find:"));
+        }
 
-                break;
-            }
-            case json_styp_key :
-            {
-                dit++;
-
-                switch (dit->struct_type)
-                {
-                    case json_styp_obj_bgn :
-                    {
-                        styp_bgn = json_styp_obj_bgn;
-                        styp_end = json_styp_obj_end;
-                        sstk     = 0;
-
-                        break;
-                    }
-                    case json_styp_arr_bgn :
-                    {
-                        styp_bgn = json_styp_arr_bgn;
-                        styp_end = json_styp_arr_end;
-                        sstk     = 0;
-
-                        break;
-                    }
-                    case json_styp_elem :
-                    {
-                        return 1;
-                    }
-                    default :
-                    {
-                        // TODO: exception
-                        return 0;
-                    }
-                }
-
-                break;
-            }
-            default :
-            {
-                return 0;
-            }
+        try
+        {
+            push->set_search_path(*(this->search_path));
+            push->put_chunk(arg_ptr, arg_len);
+            push->put_end();
+        }
+        catch (JsonPushErr & err)
+        {
+            if (this->msg != nullptr) { this->msg->cerr_err("catch() while parsing"); }
+            if (this->msg != nullptr) { this->msg->cerr_err(err.get_msg()); }
+
+            throw JsonFindErr("failure in JsonFind::find_stream():" + SP + err.get_msg());
         }
 
-        // continue for arr and obj
-        for (dit++ ; dit != search_context->end() ; dit++)
+        if (!push->is_found())
         {
-            if (dit->struct_type == styp_bgn)
-            {
-                sstk++;
-            }
-            else if (dit->struct_type == styp_end)
-            {
-                if (sstk == 0)
-                {
-                    return distance(this->search_context_iter, dit);
-                }
-                else
-                {
-                    sstk--;
-                }
-            }
+            if (this->msg != nullptr) { this->msg->cerr_inf("find:" +TB+ "no match"); }
+
+            return;
         }
 
-        return 0;
+        push->vec->swap_tape(tape);
+        this->own_context = move(tape);
+        this->own_context->set_key_index(this->key_index);
+        this->own_context->set_elem_index(this->elem_index);
+        this->search_context = this->own_context;
+
+        sel = this->search_path->get_step(this->search_path->size() - 1).sel_key;
+        this->set_context(sel ? 1 : 0, sel ? 1 : 0);
     }
 
     /** \brief Set the context
      *
-     *  The search context iterator is set to the search target token.
-     *
-     *  The search path iterator is reset to the beginning of the path.
-     *
-     *  The search target token is copied to the context token.
+     *  The search context index is set to the search target token, which
+     *  becomes the context token.  Nothing is copied, so neither this nor
+     *  the context queries allocate.
      */
     void
-    JsonFind::set_context(TokenI arg)
+    JsonFind::set_context(size_t arg_idx, size_t arg_kit)
     {
-        this->context_token       = unique_ptr<Token>(new Token(*arg));
-        this->search_context_iter = arg;
-        this->search_path_iter    = this->search_path->begin();
+        this->context_set        = true;
+        this->search_context_idx = arg_idx;
+        this->search_context_kit = arg_kit;
     }
 
     /** \brief Clear the context
      *
-     *  The search context iterator is set to the beginning.
-     *
-     *  The search path iterator is reset to the beginning.
+     *  The search context index is set to the beginning.
      *
      *  The context token is cleared.
      */
     void
     JsonFind::clr_context(void)
     {
-        this->context_token       = unique_ptr<Token>(new Token());
-        this->search_context_iter = this->search_context->begin();
-        this->search_path_iter    = this->search_path->begin();
+        this->context_set        = false;
+        this->search_context_idx = 0;
+        this->search_context_kit = 0;
+    }
+
+    /* Structural type of the context token, json_styp_LAST if cleared */
+    JsonStructTypes
+    JsonFind::context_styp(void) const
+    {
+        return this->context_set ? this->search_context->get_styp(this->search_context_idx) : json_styp_LAST;
+    }
+
+    /* Element type of the context token, json_etyp_LAST if cleared */
+    JsonElementTypes
+    JsonFind::context_etyp(void) const
+    {
+        return this->context_set ? this->search_context->get_etyp(this->search_context_idx) : json_etyp_LAST;
+    }
+
+    /** \brief Select the parser engine
+     *
+     *  Selects the engine used by later calls to set_search_context() and
+     *  set_search_path().  The default is json_engn_flex.
+     */
+    void
+    JsonFind::set_engine(JsonEngines arg_engn)
+    {
+        this->engine = arg_engn;
+    }
+
+    /** \brief Select the paths to keep when parsing
+     *
+     *  Later calls to set_search_context() keep only the values selected
+     *  by the argument paths, with the objects, arrays and keys leading to
+     *  them.  Other keys and their values are dropped, and other array
+     *  items are replaced by null or an empty object or array, so the
+     *  paths select the same values as in the whole JSON string at a
+     *  fraction of the memory.  An empty
+     *  vector keeps everything, which is the default.
+     *
+     *  With json_engn_simd and json_engn_scal, values not kept are stepped
+     *  over without decoding them, and are checked only for balanced
+     *  brackets.  With json_engn_flex, they are fully parsed and then
+     *  dropped.
+     */
+    void
+    JsonFind::set_projection(const vector<JsonPath> & arg_paths)
+    {
+        this->projection = arg_paths;
+    }
+
+    /** \brief Select the token string mode
+     *
+     *  Selects the mode used by later calls to set_search_context().  The
+     *  default is json_tmod_copy.  With json_tmod_view, keys, strings and
+     *  numbers without escape sequences are not copied out of the JSON
+     *  string; a single copy of the JSON string is retained instead.
+     */
+    void
+    JsonFind::set_token_mode(JsonTokenModes arg_tmod)
+    {
+        this->token_mode = arg_tmod;
+    }
+
+    /** \brief Select key indexing for large objects
+     *
+     *  Objects in the search context with at least the argument number
+     *  of keys are given a hash index from key to value on the first
+     *  find() into them, and later finds into them take constant time.
+     *  Zero, the default, disables indexing.  The setting applies to the
+     *  current and later search contexts.
+     */
+    void
+    JsonFind::set_key_index(size_t arg_min)
+    {
+        this->key_index = arg_min;
+
+        if (this->own_context != nullptr)
+        {
+            this->own_context->set_key_index(arg_min);
+        }
+    }
+
+    /** \brief Index all large objects of the search context now
+     *
+     *  As set_key_index(), but the indexes for the current search context
+     *  are built immediately rather than on first use.
+     */
+    void
+    JsonFind::build_key_index(size_t arg_min)
+    {
+        this->set_key_index(arg_min);
+
+        if (this->own_context != nullptr)
+        {
+            this->own_context->build_key_index();
+        }
+    }
+
+    /** \brief Select item indexing for large arrays
+     *
+     *  Arrays in the search context with at least the argument number of
+     *  items are given a table of items on the first find() into them by
+     *  index, and later finds into them by index take constant time.
+     *  Zero, the default, disables indexing.  The setting applies to the
+     *  current and later search contexts.
+     */
+    void
+    JsonFind::set_elem_index(size_t arg_min)
+    {
+        this->elem_index = arg_min;
+
+        if (this->own_context != nullptr)
+        {
+            this->own_context->set_elem_index(arg_min);
+        }
+    }
+
+    /** \brief Index all large arrays of the search context now
+     *
+     *  As set_elem_index(), but the indexes for the current search context
+     *  are built immediately rather than on first use.
+     */
+    void
+    JsonFind::build_elem_index(size_t arg_min)
+    {
+        this->set_elem_index(arg_min);
+
+        if (this->own_context != nullptr)
+        {
+            this->own_context->build_elem_index();
+        }
     }
 
     /** \brief Initialize the search context
@@ -289,31 +446,156 @@ namespace SyscJson
     void
     JsonFind::set_search_context(string & arg_str)
     {
-        this->context_token       = unique_ptr<Token>(new Token());
-        this->search_context      = unique_ptr<Tokens>(new Tokens());
+        this->context_set        = false;
+        this->own_context        = make_shared<JsonTape>();
+        this->search_context     = this->own_context;
+        this->search_context_idx = 0;
+        this->search_context_kit = 0;
+
+        this->parse(this->own_context, make_shared<const JsonSrc>(arg_str), this->token_mode);
+        this->own_context->set_key_index(this->key_index);
+        this->own_context->set_elem_index(this->elem_index);
+        this->search_context = this->own_context;
+    }
+
+    /** \brief Initialize the search context from a file
+     *
+     *  The file named by the string argument is mapped read-only,
+     *  parsed in place and if valid, saved.  With the json_tmod_view
+     *  token mode, keys, strings and numbers without escape sequences
+     *  refer to the mapping, which is held until the search context is
+     *  next set; with json_engn_simd or json_engn_scal the file is then
+     *  never copied.
+     *
+     *  The context token is cleared.
+     */
+    void
+    JsonFind::set_search_context_file(const string & arg_path)
+    {
+        shared_ptr<JsonSrc> src = make_shared<JsonSrc>();
+
+        try
+        {
+            src->set_file(arg_path);
+        }
+        catch (JsonSrcErr & err)
+        {
+            if (this->msg != nullptr) { this->msg->cerr_err(err.get_msg()); }
+
+            throw JsonFindErr("failure in JsonFind::set_search_context_file():" + SP + err.get_msg());
+        }
+
+        this->context_set        = false;
+        this->own_context        = make_shared<JsonTape>();
+        this->search_context     = this->own_context;
+        this->search_context_idx = 0;
+        this->search_context_kit = 0;
+
+        this->parse(this->own_context, src, this->token_mode);
+        this->own_context->set_key_index(this->key_index);
+        this->own_context->set_elem_index(this->elem_index);
+        this->search_context = this->own_context;
+    }
+
+    /** \brief Search a JSON string while parsing it
+     *
+     *  The JSON string argument is searched for the search path as it is
+     *  parsed, and parsing stops at the end of the value found, so a value
+     *  near the start of a large JSON string costs only the part of the
+     *  string before it.  The rest of the string is not checked.
+     *
+     *  If the search is successful, the search context is set to the value
+     *  found, or to an object holding only the key found, and the context
+     *  token to the value or key.  Further searches are made within it.
+     *
+     *  If the search is unsuccessful, the search context is emptied and
+     *  the context token is cleared.
+     *
+     *  The JSON string is parsed by JsonPush, whatever the engine set,
+     *  in the json_tmod_copy token mode.  A path with a negative array
+     *  index waits for the end of the array.
+     */
+    void
+    JsonFind::find_stream(string & arg_str)
+    {
+        this->stream(arg_str.data(), arg_str.size());
+    }
+
+    /** \brief Search a JSON file while parsing it
+     *
+     *  As find_stream(string&), for the file named by the string argument,
+     *  which is mapped read-only.  Only the pages of the file before the
+     *  end of the value found are read.
+     */
+    void
+    JsonFind::find_stream_file(const string & arg_path)
+    {
+        JsonSrc src;
 
-        this->parse(*(this->search_context), arg_str);
+        try
+        {
+            src.set_file(arg_path);
+        }
+        catch (JsonSrcErr & err)
+        {
+            if (this->msg != nullptr) { this->msg->cerr_err(err.get_msg()); }
 
-        this->search_context_iter = this->search_context->begin();
+            throw JsonFindErr("failure in JsonFind::find_stream_file():" + SP + err.get_msg());
+        }
+
+        this->stream(src.get_ptr(), src.get_len());
     }
 
+    /** \brief Initialize the search context from a shared document
+     *
+     *  The search context is the parsed JSON of the document argument,
+     *  which is shared rather than copied.  The document is not changed
+     *  by searches, so JsonFind instances in different threads may share
+     *  it.  The set_key_index() and set_elem_index() settings do not
+     *  apply to it; its indexes are those selected for the JsonDoc.
+     *
+     *  The context token is cleared.  Throws JsonFindErr, leaving the
+     *  search context as it was, if the document argument is null.
+     */
+    void
+    JsonFind::set_search_context(shared_ptr<const JsonDoc> arg_doc)
+    {
+        if (arg_doc == nullptr)
+        {
+            throw JsonFindErr("failure in JsonFind::set_search_context():" + SP + "null document");
+        }
+
+        this->context_set        = false;
+        this->own_context        = shared_ptr<JsonTape>(nullptr);
+        this->search_context     = arg_doc->get_tape();
+        this->search_context_idx = 0;
+        this->search_context_kit = 0;
+    }
 
     /** \brief Initialize the search path
      *
      *  The search path is parsed from the string argument and
-     *  if valid, saved.
+     *  if valid, saved as a JsonPath.
      *
      *  The context token is cleared.
      */
     void
     JsonFind::set_search_path(string & arg_str)
     {
-        this->context_token    = unique_ptr<Token>(new Token());
-        this->search_path      = unique_ptr<Tokens>(new Tokens());
+        this->context_set = false;
+        this->search_path = unique_ptr<JsonPath>(nullptr);
 
-        this->parse(*(this->search_path), arg_str);
+        try
+        {
+            this->search_path = unique_ptr<JsonPath>(new JsonPath(arg_str, this->engine));
+        }
+        catch (JsonPathErr & err)
+        {
+            if (this->msg != nullptr) { this->msg->cerr_err("catch() while parsing"); }
+            if (this->msg != nullptr) { this->msg->cerr_err(err.get_msg()); }
 
-        this->search_path_iter = this->search_path->begin();
+            throw JsonFindErr("failure in JsonFind::set_search_path():" + SP + err.get_msg());
+        }
     }
 
     /** \brief Search for a JSON value or [key, value] pair
@@ -326,427 +608,164 @@ namespace SyscJson
     void
     JsonFind::find(void)
     {
-        /*
-         *  * coded with the assumption that both search_context and search_path Token vectors represent
-         *    valid JSON, as provided by JsonFind::parse()
-         *  * auxiliary state variables (auxiliary to the primary state variables pit and dit)
-         *    are used
-         *      * sstk, search stack
-         *          * when encountering an immaterial object or array during
-         *            a search, sstk is incremented upon entry and decremented upon exit
-         *      * sidx, search index
-         *          * set at the beginning of an array to the number specified in the path;
-         *            it is decremented for each item in the array; selected item is found when sidx is zero
-         */
-        int     sstk = 0;
-        int     sidx = -1;
-        TokenI  pit  = this->search_path->begin();
-
-        this->clr_context();
-
-        if (this->search_context->size() == 0)
+        if (this->search_path == nullptr)
         {
+            this->clr_context();
             return;
         }
 
-        if (this->search_path->size() == 0)
+        this->find(*(this->search_path));
+    }
+
+    /** \brief Search for a JSON value or [key, value] pair along a
+     *         compiled search path
+     *
+     *  The search path argument is used in place of the one set by
+     *  set_search_path(), which is unchanged.
+     *
+     *  The path object holds one key, whose value is
+     *  + null, selecting the context key
+     *  + true, selecting the context key's value
+     *  + an object or array, to be searched for in the context key's value
+     *
+     *  The path array holds either
+     *  + nothing, selecting the context array
+     *  + a number N and either true, selecting the context array's Nth
+     *    item, or an object or array to be searched for in that item
+     *  + an object or array, to be searched for in the context array's
+     *    first item of the same type
+     *
+     *  Empty path objects and arrays select the context object or array.
+     *
+     *  If the search is successful, the context token is copied from
+     *  the search target token.
+     *
+     *  If the search is unsuccessful, the context token is cleared.
+     */
+    void
+    JsonFind::find(const JsonPath & arg_path)
+    {
+        size_t idx;
+        size_t kit;
+
+        this->clr_context();
+
+        if ((this->search_context == nullptr) || (this->search_context->empty()))
         {
             return;
         }
 
-        if (this->msg != nullptr)
+        if (this->find_path(arg_path, idx, kit))
         {
-            this->msg->cerr_inf(
-                "find:" +TB+ "dstyp" +TB+ "detyp" +TB+ "delem" +TB+ "pstyp" +TB+ "petyp" +TB+ "pelem" +TB+ "sstk" +TB+ "sidx"
-            );
-            this->msg->cerr_inf("find:" +TB+ "------------------------------------------------------------");
+            this->set_context(idx, kit);
         }
+    }
+
+    /** \brief Search for the JSON value or [key, value] pair along a
+     *         JSON Pointer
+     *
+     *  The pointer is compiled by JsonPath for the json_psyn_ptr syntax on
+     *  first use and kept by this JsonFind, so that repeated searches
+     *  along the same pointer do no compiling.  Up to 1024 pointers are
+     *  kept.  The search is otherwise as for find(const JsonPath&).
+     *
+     *  Throws JsonFindErr if the pointer is not valid.
+     */
+    void
+    JsonFind::find_pointer(const string & arg_ptr)
+    {
+        auto pit = this->pointers.find(arg_ptr);
 
-        for (TokenI dit = this->search_context->begin() ; dit != this->search_context->end() ; dit++)
+        if (pit == this->pointers.end())
         {
-            if (this->msg != nullptr)
+            if (this->pointers.size() >= 1024)
             {
-                string tmp_str = "find:" + TB;
-
-                // dit
-                tmp_str = tmp_str + str_json_struct[dit->struct_type] + TB;
-
-                if (dit->has_elem())
-                {
-                    tmp_str = tmp_str + str_json_element[dit->element_type];
-                }
+                this->pointers.clear();
+            }
 
-                tmp_str = tmp_str + TB;
+            try
+            {
+                pit = this->pointers.emplace(arg_ptr, JsonPath(arg_ptr, json_psyn_ptr)).first;
+            }
+            catch (JsonPathErr & err)
+            {
+                if (this->msg != nullptr) { this->msg->cerr_err("find_pointer():" +SP+ err.get_msg()); }
 
-                if (dit->has_elem_str())
-                {
-                    tmp_str = tmp_str + dit->element_str;
-                }
+                throw JsonFindErr("failure in JsonFind::find_pointer():" +SP+ err.get_msg());
+            }
+        }
 
-                tmp_str = tmp_str + TB;
+        this->find(pit->second);
+    }
 
-                // pit
-                tmp_str = tmp_str + str_json_struct[pit->struct_type] + TB;
+    /** \brief Search for the JSON values or [key, value] pairs along a
+     *         vector of compiled search paths
+     *
+     *  The paths are merged by their leading steps and resolved in a
+     *  single descent through the search context.  The cursors argument
+     *  is loaded with one cursor for each path, at the search target as
+     *  get_cursor() would give it, or selecting no value if the search
+     *  for that path is unsuccessful.  For a [key, value] pair the cursor
+     *  is at the value, and JsonCursor::get_key() gives the key.
+     *
+     *  The context token is cleared.
+     */
+    void
+    JsonFind::find(const vector<JsonPath> & arg_paths, vector<JsonCursor> & arg_curs)
+    {
+        const size_t        none = this->search_context ? this->search_context->size() : 0;
+        JsonTrie            trie(nullptr);
+        vector<JsonTrieHit> rslt(arg_paths.size(), JsonTrieHit { none, 0 });
 
-                if (pit->has_elem())
-                {
-                    tmp_str = tmp_str + str_json_element[pit->element_type];
-                }
+        this->clr_context();
 
-                tmp_str = tmp_str + TB;
+        arg_curs.assign(arg_paths.size(), JsonCursor());
 
-                if (pit->has_elem_str())
-                {
-                    tmp_str = tmp_str + pit->element_str;
-                }
+        if ((this->search_context == nullptr) || (this->search_context->empty()))
+        {
+            return;
+        }
 
-                tmp_str = tmp_str + TB;
-                tmp_str = tmp_str + to_string(sstk) + TB;
-                tmp_str = tmp_str + to_string(sidx);
+        for (size_t i = 0 ; i < arg_paths.size() ; i++)
+        {
+            trie.add(arg_paths[i], 0, i);
+        }
 
-                this->msg->cerr_inf(tmp_str);
-            }
+        trie.find(*(this->search_context), rslt);
 
-            switch (pit->struct_type)
+        for (size_t i = 0 ; i < rslt.size() ; i++)
+        {
+            if (rslt[i].dit != none)
             {
-                case json_styp_obj_bgn :
-                {
-                    switch (dit->struct_type)
-                    {
-                        case json_styp_obj_bgn :
-                        {
-                            // pit:OS, dit:OS
-                            if (sstk == 0)
-                            {
-                                TokenI pit_next = pit + 1;
-
-                                if (pit_next->struct_type == json_styp_obj_end)
-                                {
-                                    this->set_context(dit);
-                                    return;
-                                }
-
-                                pit++;
-                            }
-
-                            break;
-                        }
-                        case json_styp_arr_bgn :
-                        {
-                            // pit:OS, dit:AS
-                            sstk++;
-                            break;
-                        }
-                        case json_styp_arr_end :
-                        {
-                            // pit:OS, dit:AE
-                            sstk--;
-                            break;
-                        }
-                        default : break;
-                    }
-
-                    break;
-                }
-                case json_styp_arr_bgn :
-                {
-                    switch (dit->struct_type)
-                    {
-                        case json_styp_arr_bgn :
-                        {
-                            // pit:AS, dit:AS
-                            if (sstk == 0)
-                            {
-                                TokenI pit_next = pit + 1;
-
-                                if (pit_next->struct_type == json_styp_arr_end)
-                                {
-                                    this->set_context(dit);
-                                    return;
-                                }
-
-                                if (pit_next->struct_type != json_styp_elem)
-                                {
-                                    pit = pit_next;
-
-                                    break;
-                                }
-
-                                if (pit_next->element_type != json_etyp_num)
-                                {
-                                    this->clr_context();
-                                    return;
-                                }
-
-                                sidx = stoul(pit_next->element_str, nullptr, 10);
-                                pit  = pit_next;
-
-                                break;
-                            }
-
-                            break;
-                        }
-                        case json_styp_obj_bgn :
-                        {
-                            // pit:AS, dit:OS
-                            sstk++;
-                            break;
-                        }
-                        case json_styp_obj_end :
-                        {
-                            // pit:AS, dit:OE
-                            sstk--;
-                            break;
-                        }
-                        default : break;
-                    }
-
-                    break;
-                }
-                case json_styp_key :
-                {
-                    switch (dit->struct_type)
-                    {
-                        case json_styp_key :
-                        {
-                            // pit:key, dit:key
-                            if ((sstk == 0) && (dit->element_str == pit->element_str))
-                            {
-                                TokenI pit_next = pit + 1;
-                                TokenI dit_next = dit + 1;
-
-                                if (pit_next->struct_type == json_styp_elem)
-                                {
-                                    if (pit_next->element_type == json_etyp_nul)
-                                    {
-                                        this->set_context(dit);
-                                        return;
-                                    }
-                                    else if (pit_next->element_type == json_etyp_tru)
-                                    {
-                                        this->set_context(dit_next);
-                                        return;
-                                    }
-                                    else
-                                    {
-                                        this->clr_context();
-                                        return;
-                                    }
-                                }
-
-                                if (pit_next->struct_type != dit_next->struct_type)
-                                {
-                                    this->clr_context();
-                                    return;
-                                }
-
-                                pit  = pit_next;
-                            }
-
-                            break;
-                        }
-                        case json_styp_obj_bgn :
-                        {
-                            // pit:key, dit:OS
-                            sstk++;
-                            break;
-                        }
-                        case json_styp_obj_end :
-                        {
-                            // pit:key, dit:OE
-                            sstk--;
-                            break;
-                        }
-                        case json_styp_arr_bgn :
-                        {
-                            // pit:key, dit:AS
-                            sstk++;
-                            break;
-                        }
-                        case json_styp_arr_end :
-                        {
-                            // pit:key, dit:AE
-                            sstk--;
-                            break;
-                        }
-                        default : break;
-                    }
-
-                    break;
-                }
-                case json_styp_elem :
-                {
-                    switch (dit->struct_type)
-                    {
-                        case json_styp_elem :
-                        {
-                            // pit:elem, dit:elem
-                            if ((sstk == 0) && (sidx == 0))
-                            {
-                                // * dit is elem in array
-                                // * choose action based on next path structure type
-                                //   * elem, true: found, return true
-                                //   * other: undefined
-                                TokenI pit_1 = pit + 1;
-
-                                if ((pit_1->struct_type == json_styp_elem) && (pit_1->element_type == json_etyp_tru))
-                                {
-                                    this->set_context(dit);
-                                    return;
-                                }
-                                else
-                                {
-                                    this->clr_context();
-                                    return;
-                                }
-                            }
-                            else if ((sstk == 0) && (sidx > 0))
-                            {
-                                sidx--;
-                            }
-                            else if (sstk == 0)
-                            {
-                                this->clr_context();
-                                return;
-                            }
-
-                            break;
-                        }
-                        case json_styp_obj_bgn :
-                        {
-                            // pit:elem, dit:OS
-                            if ((sstk == 0) && (sidx == 0))
-                            {
-                                // * dit is value in array
-                                // * choose action based on next path structure types
-                                TokenI pit_1 = pit + 1;
-                                TokenI pit_2 = pit + 2;
-
-                                if ((pit_1->struct_type == json_styp_obj_bgn) && (pit_2->struct_type == json_styp_obj_end))
-                                {
-                                    this->set_context(dit);
-                                    return;
-                                }
-                                else if (pit_1->struct_type == json_styp_obj_bgn)
-                                {
-                                    pit = pit_2;
-
-                                    continue;
-                                }
-                                else
-                                {
-                                    this->clr_context();
-                                    return;
-                                }
-                            }
-                            else if ((sstk == 0) && (sidx > 0))
-                            {
-                                if ((pit + 1)->struct_type == json_styp_elem)
-                                {
-                                    sidx--;
-                                }
-                                else
-                                {
-                                    sidx--;
-                                    sstk++;
-                                }
-                            }
-                            else
-                            {
-                                sstk++;
-                            }
-
-                            break;
-                        }
-                        case json_styp_obj_end :
-                        {
-                            // pit:elem, dit:OE
-                            sstk--;
-                            break;
-                        }
-                        case json_styp_arr_bgn :
-                        {
-                            // pit:elem, dit:AS
-                            if ((sstk == 0) && (sidx == 0))
-                            {
-                                // * dit is value in array
-                                // * choose action based on next path structure types
-                                TokenI pit_1 = pit + 1;
-                                TokenI pit_2 = pit + 2;
-
-                                if ((pit_1->struct_type == json_styp_arr_bgn) && (pit_2->struct_type == json_styp_arr_end))
-                                {
-                                    this->set_context(dit);
-                                    return;
-                                }
-                                if (pit_1->struct_type == json_styp_arr_bgn)
-                                {
-                                    if (pit_2->struct_type != json_styp_elem)
-                                    {
-                                        pit = pit_2;
-
-                                        break;
-                                    }
-
-                                    if (pit_2->element_type != json_etyp_num)
-                                    {
-                                        this->clr_context();
-                                        return;
-                                    }
-
-                                    sidx = stoul(pit_2->element_str, nullptr, 10);
-                                    pit  = pit_2;
-
-                                    break;
-                                }
-                                else
-                                {
-                                    this->clr_context();
-                                    return;
-                                }
-                            }
-                            else if ((sstk == 0) && (sidx > 0))
-                            {
-                                if ((pit + 1)->struct_type == json_styp_elem)
-                                {
-                                    sidx--;
-                                }
-                                else
-                                {
-                                    sidx--;
-                                    sstk++;
-                                }
-                            }
-                            else
-                            {
-                                sstk++;
-                            }
-
-                            break;
-                        }
-                        case json_styp_arr_end :
-                        {
-                            // pit:elem, dit:AE
-                            if ((sstk == 0) && (sidx > -1))
-                            {
-                                this->clr_context();
-                                return;
-                            }
-
-                            sstk--;
-                            break;
-                        }
-                        default : break;
-                    }
-
-                    break;
-                }
-                default : break;
+                arg_curs[i] = JsonCursor(this->search_context, rslt[i].dit, rslt[i].kit);
             }
         }
+    }
 
-        this->clr_context();
-        return;
+    /** \brief Follow the steps of a search path through the search context
+     *
+     *  Returns true and sets the index argument to the selected token,
+     *  and the key argument to the key of the selected value or zero, if
+     *  the search is successful.
+     */
+    bool
+    JsonFind::find_path(const JsonPath & arg_path, size_t & arg_idx, size_t & arg_kit)
+    {
+        size_t dit = 0;
+        size_t kit = 0;
+
+        if (!arg_path.resolve(*(this->search_context), dit, kit, 0))
+        {
+            if (this->msg != nullptr) { this->msg->cerr_inf("find:" +TB+ "no match"); }
+
+            return false;
+        }
+
+        if (this->msg != nullptr) { this->msg->cerr_inf("find:" +TB+ "match at token" +SP+ to_string(dit)); }
+
+        arg_idx = arg_path.get_step(arg_path.size() - 1).sel_key ? kit : dit;
+        arg_kit = kit;
+        return true;
     }
 
     /** \brief Check for a cleared context
@@ -758,8 +777,8 @@ namespace SyscJson
     bool
     JsonFind::context_is_none(void)
     {
-        if (this->context_token->struct_type != json_styp_LAST) return false;
-        return false;
+        if (this->context_styp() != json_styp_LAST) return false;
+        return true;
     }
 
     /** \brief Check for JSON object begin at the context token
@@ -771,7 +790,7 @@ namespace SyscJson
     bool
     JsonFind::context_is_obj_bgn(void)
     {
-        if (this->context_token->struct_type != json_styp_obj_bgn) return false;
+        if (this->context_styp() != json_styp_obj_bgn) return false;
         return true;
     }
 
@@ -784,7 +803,7 @@ namespace SyscJson
     bool
     JsonFind::context_is_obj_end(void)
     {
-        if (this->context_token->struct_type != json_styp_obj_end) return false;
+        if (this->context_styp() != json_styp_obj_end) return false;
         return true;
     }
 
@@ -797,7 +816,7 @@ namespace SyscJson
     bool
     JsonFind::context_is_arr_bgn(void)
     {
-        if (this->context_token->struct_type != json_styp_arr_bgn) return false;
+        if (this->context_styp() != json_styp_arr_bgn) return false;
         return true;
     }
 
@@ -810,7 +829,7 @@ namespace SyscJson
     bool
     JsonFind::context_is_arr_end(void)
     {
-        if (this->context_token->struct_type != json_styp_arr_end) return false;
+        if (this->context_styp() != json_styp_arr_end) return false;
         return true;
     }
 
@@ -823,9 +842,9 @@ namespace SyscJson
     bool
     JsonFind::context_is_key(void)
     {
-        if (this->context_token->struct_type != json_styp_key) return false;
-        if (this->context_token->element_type != json_etyp_str) return false;
-        if (this->context_token->element_str == "") return false;
+        if (this->context_styp() != json_styp_key) return false;
+        if (this->context_etyp() != json_etyp_str) return false;
+        if (this->search_context->get_len(this->search_context_idx) == 0) return false;
         return true;
     }
 
@@ -838,8 +857,8 @@ namespace SyscJson
     bool
     JsonFind::context_is_str(void)
     {
-        if (this->context_token->struct_type != json_styp_elem) return false;
-        if (this->context_token->element_type != json_etyp_str) return false;
+        if (this->context_styp() != json_styp_elem) return false;
+        if (this->context_etyp() != json_etyp_str) return false;
         return true;
     }
 
@@ -852,9 +871,9 @@ namespace SyscJson
     bool
     JsonFind::context_is_num(void)
     {
-        if (this->context_token->struct_type != json_styp_elem) return false;
-        if (this->context_token->element_type != json_etyp_num) return false;
-        if (this->context_token->element_str == "") return false;
+        if (this->context_styp() != json_styp_elem) return false;
+        if (this->context_etyp() != json_etyp_num) return false;
+        if (this->search_context->get_len(this->search_context_idx) == 0) return false;
         return true;
     }
 
@@ -867,8 +886,8 @@ namespace SyscJson
     bool
     JsonFind::context_is_nul(void)
     {
-        if (this->context_token->struct_type != json_styp_elem) return false;
-        if (this->context_token->element_type != json_etyp_nul) return false;
+        if (this->context_styp() != json_styp_elem) return false;
+        if (this->context_etyp() != json_etyp_nul) return false;
         return true;
     }
 
@@ -881,8 +900,8 @@ namespace SyscJson
     bool
     JsonFind::context_is_tru(void)
     {
-        if (this->context_token->struct_type != json_styp_elem) return false;
-        if (this->context_token->element_type != json_etyp_tru) return false;
+        if (this->context_styp() != json_styp_elem) return false;
+        if (this->context_etyp() != json_etyp_tru) return false;
         return true;
     }
 
@@ -895,8 +914,8 @@ namespace SyscJson
     bool
     JsonFind::context_is_fal(void)
     {
-        if (this->context_token->struct_type != json_styp_elem) return false;
-        if (this->context_token->element_type != json_etyp_fal) return false;
+        if (this->context_styp() != json_styp_elem) return false;
+        if (this->context_etyp() != json_etyp_fal) return false;
         return true;
     }
 
@@ -935,27 +954,273 @@ namespace SyscJson
         }
         else if (this->context_is_num())
         {
-            arg = this->context_token->element_str;
+            arg.assign(this->search_context->get_ptr(this->search_context_idx), this->search_context->get_len(this->search_context_idx));
         }
         else if (this->context_is_str())
         {
-            arg = this->context_token->element_str;
+            arg.assign(this->search_context->get_ptr(this->search_context_idx), this->search_context->get_len(this->search_context_idx));
         }
         else if (this->context_is_key())
         {
-            arg = this->context_token->element_str;
+            arg.assign(this->search_context->get_ptr(this->search_context_idx), this->search_context->get_len(this->search_context_idx));
         }
         else
         {
-            ptrdiff_t dist = this->get_dist();
-            Tokens    tvec;
-            JsonStr   jstr;
-
-            tvec.assign(this->search_context_iter, (this->search_context_iter) + dist + 1);
-            jstr.add_val(tvec);
-            arg = jstr.get_str();
+            this->search_context->get_string(this->search_context_idx, arg);
         }
 
         return;
     }
+
+    /** \brief Get the JSON source text of the value at the context token
+     *
+     *  Returns true and sets the arguments to the start and length of
+     *  the text in the search context JSON string.  This is the whole
+     *  object or array for array or object begin tokens, the text between
+     *  the quotes for key or string tokens, and the text of the value
+     *  otherwise.  Escape sequences and whitespace are as in the JSON
+     *  string, and nothing is copied.
+     *
+     *  Returns false for a cleared context, or unless the search context
+     *  was set in the json_tmod_view token mode.  The text is valid while
+     *  the search context is unchanged.
+     */
+    bool
+    JsonFind::get_context_view(const char * & arg_ptr, size_t & arg_len)
+    {
+        if (this->context_is_none())
+        {
+            return false;
+        }
+
+        return this->search_context->get_view(this->search_context_idx, arg_ptr, arg_len);
+    }
+
+    /* Throws for a failed conversion of the context token by the method
+     * named by the first argument
+     */
+    void
+    JsonFind::conv_err(const char * arg_fn, const char * arg_msg)
+    {
+        string tmp = string(arg_msg);
+
+        if (this->msg != nullptr) { this->msg->cerr_err(string(arg_fn) + ":" +SP+ tmp); }
+
+        throw JsonFindErr("failure in JsonFind::" + string(arg_fn) + ":" + SP + tmp);
+    }
+
+    /** \brief Get the number at the context token as a signed integer
+     *
+     *  The number is converted directly from the token text, without
+     *  allocating.  Throws JsonFindErr if the context token is not a
+     *  number, if the number has a fraction or exponent, or if it is out of
+     *  the range of int64_t.
+     */
+    void
+    JsonFind::get_context_int64(int64_t & arg_val)
+    {
+        if (!this->context_is_num())
+        {
+            this->conv_err("get_context_int64()", "context token is not a number");
+        }
+
+        switch (json_get_int64(this->search_context->get_ptr(this->search_context_idx), this->search_context->get_len(this->search_context_idx), arg_val))
+        {
+            case json_num_frac  : this->conv_err("get_context_int64()", "number is not an integer"); break;
+            case json_num_range : this->conv_err("get_context_int64()", "number is out of range");   break;
+            default             : break;
+        }
+    }
+
+    /** \brief Get the number at the context token as an unsigned integer
+     *
+     *  As get_context_int64(), for the range of uint64_t.  A negative
+     *  number other than -0 is out of range.
+     */
+    void
+    JsonFind::get_context_uint64(uint64_t & arg_val)
+    {
+        if (!this->context_is_num())
+        {
+            this->conv_err("get_context_uint64()", "context token is not a number");
+        }
+
+        switch (json_get_uint64(this->search_context->get_ptr(this->search_context_idx), this->search_context->get_len(this->search_context_idx), arg_val))
+        {
+            case json_num_frac  : this->conv_err("get_context_uint64()", "number is not an integer"); break;
+            case json_num_range : this->conv_err("get_context_uint64()", "number is out of range");   break;
+            default             : break;
+        }
+    }
+
+    /** \brief Get the number at the context token as a double
+     *
+     *  Numbers of up to 19 significant digits with a decimal exponent of
+     *  at most 22 either way, which covers most JSON, are converted
+     *  exactly from the token text without allocating.  Others are
+     *  converted by strtod() in the "C" locale, whatever locale the
+     *  program has set.  Throws JsonFindErr if the context token is
+     *  not a number, or if the number is beyond the range of double.
+     *  Numbers too small for a double become zero.
+     */
+    void
+    JsonFind::get_context_double(double & arg_val)
+    {
+        if (!this->context_is_num())
+        {
+            this->conv_err("get_context_double()", "context token is not a number");
+        }
+
+        if (json_get_double(this->search_context->get_ptr(this->search_context_idx), this->search_context->get_len(this->search_context_idx), arg_val) != json_num_ok)
+        {
+            this->conv_err("get_context_double()", "number is out of range");
+        }
+    }
+
+    /** \brief Get the true or false at the context token
+     *
+     *  Throws JsonFindErr if the context token is neither true nor false.
+     */
+    void
+    JsonFind::get_context_bool(bool & arg_val)
+    {
+        if ((!this->context_is_tru()) && (!this->context_is_fal()))
+        {
+            this->conv_err("get_context_bool()", "context token is not true or false");
+        }
+
+        arg_val = this->context_is_tru();
+    }
+
+    /* Throws for an item that get_context_array() could not convert */
+    void
+    JsonFind::item_err(size_t arg_item, int arg_stat)
+    {
+        string tmp = "item" +SP+ to_string(arg_item) +SP;
+
+        switch (arg_stat)
+        {
+            case json_num_type : tmp += "is not a number";    break;
+            case json_num_frac : tmp += "is not an integer";  break;
+            default            : tmp += "is out of range";    break;
+        }
+
+        this->conv_err("get_context_array()", tmp.c_str());
+    }
+
+    /** \brief Get the numbers of the array at the context token as doubles
+     *
+     *  The vector is cleared and filled with the items of the array in
+     *  order, each converted as by get_context_double(), in a single pass
+     *  over the search context.  Throws JsonFindErr if the context token
+     *  is not the beginning of an array, or naming the first item that is
+     *  not a number or is out of range, in which case the vector holds the
+     *  items before it.
+     */
+    void
+    JsonFind::get_context_array(vector<double> & arg_vec)
+    {
+        JsonNumStats stat;
+        size_t       item;
+
+        if (!this->context_is_arr_bgn())
+        {
+            this->conv_err("get_context_array()", "context token is not an array");
+        }
+
+        item = get_items(*this->search_context, this->search_context_idx, arg_vec, json_get_double, stat);
+
+        if (stat != json_num_ok)
+        {
+            this->item_err(item, stat);
+        }
+    }
+
+    /** \brief Get the numbers of the array at the context token as signed
+     *  integers
+     *
+     *  As get_context_array() for doubles, with each item converted as by
+     *  get_context_int64().
+     */
+    void
+    JsonFind::get_context_array(vector<int64_t> & arg_vec)
+    {
+        JsonNumStats stat;
+        size_t       item;
+
+        if (!this->context_is_arr_bgn())
+        {
+            this->conv_err("get_context_array()", "context token is not an array");
+        }
+
+        item = get_items(*this->search_context, this->search_context_idx, arg_vec, json_get_int64, stat);
+
+        if (stat != json_num_ok)
+        {
+            this->item_err(item, stat);
+        }
+    }
+
+    /** \brief Get the numbers of the array at the context token as bytes
+     *
+     *  As get_context_array() for doubles, with each item an integer from
+     *  0 to 255.
+     */
+    void
+    JsonFind::get_context_array(vector<uint8_t> & arg_vec)
+    {
+        JsonNumStats stat;
+        size_t       item;
+
+        if (!this->context_is_arr_bgn())
+        {
+            this->conv_err("get_context_array()", "context token is not an array");
+        }
+
+        item = get_items(*this->search_context, this->search_context_idx, arg_vec, get_byte, stat);
+
+        if (stat != json_num_ok)
+        {
+            this->item_err(item, stat);
+        }
+    }
+
+    /** \brief Get a cursor at the context token
+     *
+     *  For a context key, the cursor is at the key's value.  The cursor
+     *  selects no value for a cleared context.  It holds the search
+     *  context, which is unaffected by later calls to
+     *  set_search_context().
+     */
+    JsonCursor
+    JsonFind::get_cursor(void)
+    {
+        if (this->context_is_none())
+        {
+            return JsonCursor();
+        }
+
+        if (this->context_styp() == json_styp_key)
+        {
+            return JsonCursor(this->search_context, this->search_context->next(this->search_context_idx), this->search_context_idx);
+        }
+
+        return JsonCursor(this->search_context, this->search_context_idx, this->search_context_kit);
+    }
+
+    /** \brief Get a cursor at the top-level object or array of the search
+     *         context
+     *
+     *  The cursor selects no value if the search context is not set.
+     */
+    JsonCursor
+    JsonFind::get_root(void)
+    {
+        if ((this->search_context == nullptr) || (this->search_context->empty()))
+        {
+            return JsonCursor();
+        }
+
+        return JsonCursor(this->search_context, 0, 0);
+    }
 }
@@ -24,16 +24,33 @@
 #ifndef _JSON_H_
     #define _JSON_H_
 
+    #include <cstdint>
     #include <string>
+    #include <vector>
+    #include <unordered_map>
     #include <SyscMsg.h>
     #include <JsonToken.h>
+    #include <JsonTape.h>
+    #include <JsonPath.h>
+    #include <JsonCursor.h>
+    #include <JsonDoc.h>
+
+    namespace JsonParse
+    {
+        class JsonSrc;
+    }
 
     namespace SyscJson
     {
         using SyscMsg::Msg;
-        using std::ptrdiff_t;
         using std::unique_ptr;
+        using std::shared_ptr;
         using std::string;
+        using std::vector;
+        using std::unordered_map;
+        using std::int64_t;
+        using std::uint64_t;
+        using std::uint8_t;
 
         /** \class JsonFindErr
          *  \brief Exception class for JsonFind
@@ -69,50 +86,145 @@
          *  The set_search_context() method validates a JSON string and loads
          *  it into search context.
          *
+         *  The set_search_context_file() method does the same for a JSON
+         *  file, which is mapped into memory and parsed in place.  A
+         *  JsonDoc parsed once may instead be passed to
+         *  set_search_context() and shared by many JsonFind instances.
+         *
          *  The set_search_path() method validates a JSON string and loads
          *  it into search path.
          *
          *  The find() method searches for the context token specified by the
-         *  search path within the search context.
+         *  search path within the search context.  A search path compiled
+         *  once as a JsonPath may instead be passed to find(), as may a
+         *  vector of them, which are resolved together into a JsonCursor
+         *  for each.
+         *
+         *  The find_pointer() method takes the search path as an RFC 6901
+         *  JSON Pointer, such as "/key12/6/3/1", compiled without JSON
+         *  parsing and kept for reuse.
+         *
+         *  The find_stream() and find_stream_file() methods instead search
+         *  a JSON string as it is parsed, stopping at the end of the value
+         *  found, which becomes the search context.
          *
          *  The get_context_string() returns a string representation of what
-         *  is contained at the context token.
+         *  is contained at the context token.  In the json_tmod_view token
+         *  mode, get_context_view() instead gives the text of the JSON
+         *  string at the context token without copying it.
+         *
+         *  The get_context_int64(), get_context_uint64(),
+         *  get_context_double() and get_context_bool() methods convert the
+         *  value at the context token directly from the token text.  The
+         *  get_context_array() methods convert all the items of an array at
+         *  the context token in one pass, into a vector of double, int64_t
+         *  or uint8_t.
+         *
+         *  The set_engine() method selects the parser used by
+         *  set_search_context() and set_search_path().
+         *
+         *  The set_token_mode() method selects whether set_search_context()
+         *  copies string and number data out of the JSON string or refers to
+         *  a retained copy of it.
+         *
+         *  The search context is held as a JsonTape, and find() descends
+         *  through it along the steps of the JsonPath, stepping over the
+         *  values of keys and array items that are not on the path.  The
+         *  context token is held as an index into the search context, so
+         *  once the search path is compiled, find() and the context queries
+         *  make no heap allocations.
+         *
+         *  The get_cursor() and get_root() methods return a JsonCursor at
+         *  the context token or at the top level of the search context,
+         *  from which further searches and navigation need no parsing.
+         *
+         *  The set_projection() method selects the paths whose values are
+         *  kept by set_search_context(), the rest of the JSON string being
+         *  stepped over rather than loaded.
+         *
+         *  The set_key_index() and build_key_index() methods give large
+         *  objects a hash index for key lookups, and set_elem_index() and
+         *  build_elem_index() give large arrays a table of items for
+         *  lookups by index.
+         *
+         *  <h2 class="mp">Threads</h2>
+         *
+         *  The parser keeps no global state, so separate JsonFind instances
+         *  may parse and search concurrently from different threads.  They
+         *  may also search one shared JsonDoc concurrently, each holding
+         *  only its search path and context token.
          */
         class JsonFind
         {
             private:
-            unique_ptr<Msg>     msg;
-            unique_ptr<Tokens>  search_context;
-            TokenI              search_context_iter;
-            unique_ptr<Tokens>  search_path;
-            TokenI              search_path_iter;
-            unique_ptr<Token>   context_token;
+            unique_ptr<Msg>                 msg;
+            shared_ptr<const JsonTape>      search_context;
+            shared_ptr<JsonTape>            own_context;
+            size_t                          search_context_idx;
+            size_t                          search_context_kit;
+            unique_ptr<JsonPath>            search_path;
+            bool                            context_set;
+            JsonEngines                     engine;
+            JsonTokenModes                  token_mode;
+            size_t                          key_index;
+            size_t                          elem_index;
+            vector<JsonPath>                projection;
+            unordered_map<string, JsonPath> pointers;
 
-            void      parse       ( Tokens&, string& );
-            ptrdiff_t get_dist    ( void    );
-            void      set_context ( TokenI  );
-            void      clr_context ( void    );
+            void             parse        ( shared_ptr<JsonTape>&, shared_ptr<const JsonParse::JsonSrc>, JsonTokenModes );
+            void             stream       ( const char*, size_t                                                         );
+            bool             find_path    ( const JsonPath&, size_t&, size_t&                                           );
+            void             set_context  ( size_t, size_t                                                              );
+            void             clr_context  ( void                                                                        );
+            JsonStructTypes  context_styp ( void                                                                        ) const;
+            JsonElementTypes context_etyp ( void                                                                        ) const;
+            void             conv_err     ( const char*, const char*                                                    );
+            void             item_err     ( size_t, int                                                                 );
 
             public:
             JsonFind(const string&);
             JsonFind(void);
             ~JsonFind(void);
 
-            void      set_search_context   ( string& );
-            void      set_search_path      ( string& );
-            void      find                 ( void    );
-            bool      context_is_none      ( void    );
-            bool      context_is_obj_bgn   ( void    );
-            bool      context_is_obj_end   ( void    );
-            bool      context_is_arr_bgn   ( void    );
-            bool      context_is_arr_end   ( void    );
-            bool      context_is_key       ( void    );
-            bool      context_is_str       ( void    );
-            bool      context_is_num       ( void    );
-            bool      context_is_nul       ( void    );
-            bool      context_is_tru       ( void    );
-            bool      context_is_fal       ( void    );
-            void      get_context_string   ( string& );
+            void       set_engine              ( JsonEngines                                  );
+            void       set_token_mode          ( JsonTokenModes                               );
+            void       set_projection          ( const vector<JsonPath>&                      );
+            void       set_key_index           ( size_t                                       );
+            void       build_key_index         ( size_t                                       );
+            void       set_elem_index          ( size_t                                       );
+            void       build_elem_index        ( size_t                                       );
+            void       set_search_context      ( string&                                      );
+            void       set_search_context      ( shared_ptr<const JsonDoc>                    );
+            void       set_search_context_file ( const string&                                );
+            void       set_search_path         ( string&                                      );
+            void       find                    ( void                                         );
+            void       find                    ( const JsonPath&                              );
+            void       find                    ( const vector<JsonPath>&, vector<JsonCursor>& );
+            void       find_pointer            ( const string&                                );
+            void       find_stream             ( string&                                      );
+            void       find_stream_file        ( const string&                                );
+            bool       context_is_none         ( void                                         );
+            bool       context_is_obj_bgn      ( void                                         );
+            bool       context_is_obj_end      ( void                                         );
+            bool       context_is_arr_bgn      ( void                                         );
+            bool       context_is_arr_end      ( void                                         );
+            bool       context_is_key          ( void                                         );
+            bool       context_is_str          ( void                                         );
+            bool       context_is_num          ( void                                         );
+            bool       context_is_nul          ( void                                         );
+            bool       context_is_tru          ( void                                         );
+            bool       context_is_fal          ( void                                         );
+            void       get_context_string      ( string&                                      );
+            bool       get_context_view        ( const char*&, size_t&                        );
+            void       get_context_int64       ( int64_t&                                     );
+            void       get_context_uint64      ( uint64_t&                                    );
+            void       get_context_double      ( double&                                      );
+            void       get_context_bool        ( bool&                                        );
+            void       get_context_array       ( vector<double>&                              );
+            void       get_context_array       ( vector<int64_t>&                             );
+            void       get_context_array       ( vector<uint8_t>&                             );
+            JsonCursor get_cursor              ( void                                         );
+            JsonCursor get_root                ( void                                         );
         };
     }
 #endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _JSON_NUM_H_
+    #define _JSON_NUM_H_
+
+    #include <cstddef>
+    #include <cstdint>
+
+    namespace JsonParse
+    {
+        using std::size_t;
+        using std::int64_t;
+        using std::uint64_t;
+
+        /* Longest text written by the json_fmt_*() functions */
+        const size_t json_fmt_max = 32;
+
+        /* Outcomes of converting a JSON number */
+        enum JsonNumStats
+        {
+            json_num_ok,      // converted
+            json_num_type,    // not a number
+            json_num_frac,    // not an integer
+            json_num_range    // out of range
+        };
+
+        /* Number parsing
+         *
+         * The json_get_*() functions convert the JSON number text of
+         * their arguments, which json_is_number() accepts, without regard
+         * to the locale of the program.
+         */
+        bool         json_is_number  ( const char*, size_t            );
+        JsonNumStats json_get_int64  ( const char*, size_t, int64_t&  );
+        JsonNumStats json_get_uint64 ( const char*, size_t, uint64_t& );
+        JsonNumStats json_get_double ( const char*, size_t, double&   );
+
+        /* Number formatting
+         *
+         * Each function writes the JSON text of its number argument to the
+         * buffer argument, which must hold json_fmt_max characters, and
+         * returns the length written.  No terminating NUL is written.
+         */
+        size_t json_fmt_uint64 ( char*, uint64_t );
+        size_t json_fmt_int64  ( char*, int64_t  );
+        size_t json_fmt_double ( char*, double   );
+
+        /* strtod() in the "C" numeric locale, whatever the locale of the
+         * program, for JSON number text
+         */
+        double json_strtod ( const char* );
+    }
+#endif
@@ -0,0 +1,479 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** \file  JsonPath.cxx
+ *  \brief Defines the JsonPath and JsonPathErr classes.
+ */
+
+#include <JsonVec.h>
+#include <JsonTape.h>
+#include <JsonPath.h>
+
+namespace SyscJson
+{
+    using namespace std;
+    using namespace SyscMsg;
+    using namespace SyscMsg::Chars;
+    using namespace JsonParse;
+
+    // =============================================================================
+    // Class JsonPathErr
+    // =============================================================================
+    /** \brief Constructor for JsonPathErr exception class
+     *
+     *  Argument string may be used to describe the exception.
+     *
+     */
+    JsonPathErr::JsonPathErr(string s)
+    {
+        this->err_msg = s;
+    }
+
+    /** \brief Destructor for JsonPathErr exception class
+     *
+     *  No-op.
+     *
+     */
+    JsonPathErr::~JsonPathErr(void)
+    {
+    }
+
+    /** \brief Accessor method for JsonPathErr exception message
+     *
+     *  Returns the message string.
+     *
+     */
+    string
+    JsonPathErr::get_msg(void)
+    {
+        return "JsonPathErr reports" + SP + this->err_msg;
+    }
+
+    // =============================================================================
+    // Class JsonPath
+    // =============================================================================
+    /** \brief Constructor for JsonPath, using the given parser engine
+     *
+     *  Throws JsonPathErr if the string argument is not valid JSON.
+     */
+    JsonPath::JsonPath(const string & arg_str, JsonEngines arg_engn)
+    {
+        this->compile(arg_str, arg_engn);
+    }
+
+    /** \brief Constructor for JsonPath, using the given path syntax
+     *
+     *  Throws JsonPathErr if the string argument is not a valid path in
+     *  that syntax.
+     */
+    JsonPath::JsonPath(const string & arg_str, JsonPathSyntaxes arg_psyn)
+    {
+        if (arg_psyn == json_psyn_ptr)
+        {
+            this->compile_ptr(arg_str);
+        }
+        else
+        {
+            this->compile(arg_str, json_engn_flex);
+        }
+    }
+
+    /** \brief Constructor for JsonPath
+     *
+     *  Throws JsonPathErr if the string argument is not valid JSON.
+     */
+    JsonPath::JsonPath(const string & arg_str)
+    {
+        this->compile(arg_str, json_engn_flex);
+    }
+
+    /** \brief Destructor for JsonPath
+     *
+     *   No-op.
+     */
+    JsonPath::~JsonPath(void) { }
+
+    /* Walk the path objects and arrays from the top level down,
+     * adding a step for each.  See JsonFind::find() for the path forms.
+     */
+    void
+    JsonPath::compile(const string & arg_str, JsonEngines arg_engn)
+    {
+        unique_ptr<JsonVec>  jv;
+        unique_ptr<JsonTape> tape;
+        JsonPathStep         step;
+        size_t               pit = 0;
+
+        try
+        {
+            jv = unique_ptr<JsonVec>(new JsonVec(arg_str, arg_engn, json_tmod_copy));
+        }
+        catch (JsonVecErr & err)
+        {
+            throw JsonPathErr("failure in JsonPath::compile():" + SP + err.get_msg());
+        }
+
+        jv->swap_tape(tape);
+
+        step.op       = json_path_root;
+        step.styp     = tape->get_styp(pit);
+        step.sel_key  = false;
+        step.from_end = false;
+        step.idx      = 0;
+
+        this->steps.push_back(step);
+
+        while (true)
+        {
+            size_t pit_1 = tape->next(pit);
+            size_t pit_2;
+
+            step          = JsonPathStep();
+            step.from_end = false;
+            step.idx      = 0;
+
+            if (tape->get_styp(pit) == json_styp_obj_bgn)
+            {
+                if (tape->get_styp(pit_1) == json_styp_obj_end)
+                {
+                    return;
+                }
+
+                pit_2        = tape->next(pit_1);
+                step.op      = json_path_key;
+                step.key     = string(tape->get_ptr(pit_1), tape->get_len(pit_1));
+                step.styp    = tape->get_styp(pit_2);
+                step.sel_key = false;
+
+                if (step.styp == json_styp_elem)
+                {
+                    switch (tape->get_etyp(pit_2))
+                    {
+                        case json_etyp_nul : step.sel_key = true;   break;
+                        case json_etyp_tru : break;
+                        default            : step.op = json_path_none; break;
+                    }
+
+                    step.styp = json_styp_LAST;
+                    this->steps.push_back(step);
+                    return;
+                }
+            }
+            else
+            {
+                if (tape->get_styp(pit_1) == json_styp_arr_end)
+                {
+                    return;
+                }
+
+                step.sel_key = false;
+
+                if (tape->get_styp(pit_1) != json_styp_elem)
+                {
+                    step.op   = json_path_first;
+                    step.styp = tape->get_styp(pit_1);
+
+                    this->steps.push_back(step);
+                    pit = pit_1;
+                    continue;
+                }
+
+                pit_2     = tape->next(pit_1);
+                step.op   = json_path_idx;
+                step.styp = tape->get_styp(pit_2);
+
+                if (tape->get_etyp(pit_1) != json_etyp_num)
+                {
+                    step.op = json_path_none;
+                }
+                else
+                {
+                    string num(tape->get_ptr(pit_1), tape->get_len(pit_1));
+
+                    // a negative index counts from the end, -1 being the last item
+                    if (num[0] == '-')
+                    {
+                        step.from_end = true;
+                        num.erase(0, 1);
+                    }
+
+                    try
+                    {
+                        step.idx = stoul(num, nullptr, 10);
+                    }
+                    catch (out_of_range & err)
+                    {
+                        step.op = json_path_none;
+                    }
+
+                    if (step.from_end && (step.idx == 0))
+                    {
+                        step.op = json_path_none;
+                    }
+                }
+
+                if (step.styp == json_styp_elem)
+                {
+                    if (tape->get_etyp(pit_2) != json_etyp_tru)
+                    {
+                        step.op = json_path_none;
+                    }
+
+                    this->steps.push_back(step);
+                    return;
+                }
+
+                if (step.styp == json_styp_arr_end)
+                {
+                    step.op = json_path_none;
+
+                    this->steps.push_back(step);
+                    return;
+                }
+            }
+
+            this->steps.push_back(step);
+            pit = pit_2;
+        }
+    }
+
+    /* Split a JSON Pointer into reference tokens, undoing the ~0 and ~1
+     * escapes, adding a member step for each token that is an array index
+     * and a key step for any other
+     */
+    void
+    JsonPath::compile_ptr(const string & arg_str)
+    {
+        JsonPathStep step;
+        size_t       pit = 0;
+
+        step.op       = json_path_root;
+        step.styp     = json_styp_LAST;
+        step.sel_key  = false;
+        step.from_end = false;
+        step.idx      = 0;
+
+        this->steps.push_back(step);
+
+        if ((!arg_str.empty()) && (arg_str[0] != '/'))
+        {
+            throw JsonPathErr("failure in JsonPath::compile_ptr():" + SP + "pointer does not begin with '/'");
+        }
+
+        while (pit < arg_str.size())
+        {
+            size_t num = 0;
+            bool   idx = true;
+
+            step = JsonPathStep();
+            step.op       = json_path_key;
+            step.styp     = json_styp_LAST;
+            step.sel_key  = false;
+            step.from_end = false;
+            step.idx      = 0;
+
+            for (pit++ ; (pit < arg_str.size()) && (arg_str[pit] != '/') ; pit++)
+            {
+                char c = arg_str[pit];
+
+                if (c == '~')
+                {
+                    pit++;
+
+                    if      ((pit < arg_str.size()) && (arg_str[pit] == '0')) { c = '~'; }
+                    else if ((pit < arg_str.size()) && (arg_str[pit] == '1')) { c = '/'; }
+                    else
+                    {
+                        throw JsonPathErr("failure in JsonPath::compile_ptr():" + SP + "'~' is not followed by '0' or '1'");
+                    }
+
+                    idx = false;
+                }
+                else if ((c >= '0') && (c <= '9') && (idx))
+                {
+                    idx = ((num > 0) || step.key.empty()) && (num <= (~size_t(0) - 9) / 10);
+                    num = num * 10 + static_cast<size_t>(c - '0');
+                }
+                else
+                {
+                    idx = false;
+                }
+
+                step.key.push_back(c);
+            }
+
+            // an array index is "0" or digits without a leading zero
+            if ((idx) && (!step.key.empty()))
+            {
+                step.op  = json_path_member;
+                step.idx = num;
+            }
+
+            this->steps.push_back(step);
+        }
+    }
+
+    /** \brief Number of steps in the path
+     *
+     */
+    size_t
+    JsonPath::size(void) const
+    {
+        return this->steps.size();
+    }
+
+    /** \brief Step at the argument index
+     *
+     */
+    const JsonPathStep &
+    JsonPath::get_step(size_t arg_idx) const
+    {
+        return this->steps[arg_idx];
+    }
+
+    /* Follow the steps from the step at the last argument and the token
+     * at the first index argument, setting it to the value reached and
+     * the second index argument to the key of that value, or zero if it
+     * is not an object member
+     */
+    bool
+    JsonPath::resolve(const JsonTape & arg_tape, size_t & arg_dit, size_t & arg_kit, size_t arg_step) const
+    {
+        size_t dit = arg_dit;
+        size_t kit = arg_kit;
+        size_t vit;
+
+        for (size_t i = arg_step ; i < this->steps.size() ; i++)
+        {
+            const JsonPathStep & step = this->steps[i];
+
+            switch (step.op)
+            {
+                case json_path_root :
+                {
+                    break;
+                }
+                case json_path_key :
+                {
+                    if (arg_tape.get_styp(dit) != json_styp_obj_bgn)
+                    {
+                        return false;
+                    }
+
+                    kit = arg_tape.find_key(dit, step.key.data(), step.key.size());
+
+                    if (arg_tape.get_styp(kit) != json_styp_key)
+                    {
+                        return false;
+                    }
+
+                    dit = arg_tape.next(kit);
+                    break;
+                }
+                case json_path_idx :
+                {
+                    if (arg_tape.get_styp(dit) != json_styp_arr_bgn)
+                    {
+                        return false;
+                    }
+
+                    vit = arg_tape.find_elem(dit, step.idx, step.from_end);
+
+                    if (arg_tape.get_styp(vit) == json_styp_arr_end)
+                    {
+                        return false;
+                    }
+
+                    kit = 0;
+                    dit = vit;
+                    break;
+                }
+                case json_path_member :
+                {
+                    if (arg_tape.get_styp(dit) == json_styp_obj_bgn)
+                    {
+                        kit = arg_tape.find_key(dit, step.key.data(), step.key.size());
+
+                        if (arg_tape.get_styp(kit) != json_styp_key)
+                        {
+                            return false;
+                        }
+
+                        dit = arg_tape.next(kit);
+                        break;
+                    }
+
+                    if (arg_tape.get_styp(dit) != json_styp_arr_bgn)
+                    {
+                        return false;
+                    }
+
+                    vit = arg_tape.find_elem(dit, step.idx, false);
+
+                    if (arg_tape.get_styp(vit) == json_styp_arr_end)
+                    {
+                        return false;
+                    }
+
+                    kit = 0;
+                    dit = vit;
+                    break;
+                }
+                case json_path_first :
+                {
+                    if (arg_tape.get_styp(dit) != json_styp_arr_bgn)
+                    {
+                        return false;
+                    }
+
+                    for (vit = arg_tape.next(dit) ; arg_tape.get_styp(vit) != json_styp_arr_end ; vit = arg_tape.skip(vit))
+                    {
+                        if (arg_tape.get_styp(vit) == step.styp)
+                        {
+                            break;
+                        }
+                    }
+
+                    if (arg_tape.get_styp(vit) == json_styp_arr_end)
+                    {
+                        return false;
+                    }
+
+                    kit = 0;
+                    dit = vit;
+                    break;
+                }
+                default :
+                {
+                    return false;
+                }
+            }
+
+            if ((step.styp != json_styp_LAST) && (arg_tape.get_styp(dit) != step.styp))
+            {
+                return false;
+            }
+        }
+
+        arg_dit = dit;
+        arg_kit = kit;
+        return true;
+    }
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** \file  JsonPath.h
+ *  \brief Declares the JsonPath and JsonPathErr classes.
+ */
+
+#ifndef _JSON_PATH_H_
+    #define _JSON_PATH_H_
+
+    #include <string>
+    #include <vector>
+    #include <JsonToken.h>
+
+    namespace SyscJson
+    {
+        class JsonTape;
+        class JsonFind;
+        class JsonCursor;
+        class JsonPush;
+
+        using std::string;
+        using std::vector;
+        using std::size_t;
+
+        /** \class JsonPathErr
+         *  \brief Exception class for JsonPath
+         *
+         *  This class is thrown by the JsonPath constructors in the event
+         *  of a JSON parsing error.
+         *
+         *  The err_msg string is set in the constructor and may be
+         *  used to indicate why the exception was thrown.  It is
+         *  accessed by the get_msg() method.
+         */
+        /** \var   JsonPathErr::err_msg
+         *  \brief String data for exception message
+         */
+        class JsonPathErr
+        {
+            public:
+            string err_msg;
+
+            JsonPathErr(string);
+            ~JsonPathErr(void);
+
+            string get_msg(void);
+        };
+
+        /** \brief Search path step operations
+         *
+         *  Each step of a JsonPath moves from the current token of the
+         *  search context by
+         *  + checking the top-level object or array
+         *  + taking the value of an object key
+         *  + taking an array item by index
+         *  + taking the first array item of a given structural type
+         *  + taking the value of an object key or, from an array, the item
+         *    at the index the key spells, as in a JSON Pointer
+         *  + failing, for a path that cannot select anything
+         */
+        enum JsonPathOps
+        {
+            json_path_root,       /**< top-level object or array   */
+            json_path_key,        /**< value of object key         */
+            json_path_idx,        /**< array item at index         */
+            json_path_first,      /**< first array item of type    */
+            json_path_member,     /**< object key or array index   */
+            json_path_none,       /**< no match                    */
+            json_path_LAST        /**< end of enumeration          */
+        };
+
+        /** \brief Search path syntaxes
+         *
+         *  A search path may be written as JSON, as taken by
+         *  JsonFind::set_search_path(), or as an RFC 6901 JSON Pointer.
+         */
+        enum JsonPathSyntaxes
+        {
+            json_psyn_json,       /**< JSON search path            */
+            json_psyn_ptr,        /**< JSON Pointer                */
+            json_psyn_LAST        /**< end of enumeration          */
+        };
+
+        /** \class JsonPathStep
+         *  \brief One step of a JsonPath
+         *
+         *  The token reached by the step must have structural type #styp,
+         *  unless #styp is json_styp_LAST.  When #sel_key is set on the
+         *  last step, the key is selected rather than its value.  When
+         *  #from_end is set, #idx counts back from the end of the array,
+         *  the last item being 1.
+         */
+        class JsonPathStep
+        {
+            public:
+            JsonPathOps     op;
+            JsonStructTypes styp;
+            bool            sel_key;
+            bool            from_end;
+            size_t          idx;
+            string          key;
+        };
+
+        /** \class JsonPath
+         *  \brief Compiled search path
+         *
+         *  The constructors parse and validate a search path, as taken by
+         *  JsonFind::set_search_path(), into a flat list of steps.  The
+         *  path may then be used with JsonFind::find(const JsonPath&) on
+         *  any search context.
+         *
+         *  A path that parses but cannot select any value compiles to a
+         *  path that never matches.
+         *
+         *  A JSON Pointer such as "/key12/6/3/1" is split at each '/' by a
+         *  small tokenizer, with no JSON parsing.  Each reference token
+         *  selects the value of that key from an object or, if it is an
+         *  array index, the item at that index from an array.  The value
+         *  selected may be of any type, and the empty pointer selects the
+         *  top-level object or array.
+         *
+         *  A path is resolved from the top level of a search context by
+         *  JsonFind, or from any value by JsonCursor::find().
+         *
+         *  A JsonPath is not changed after construction, so one instance
+         *  may be shared by JsonFind instances in different threads.
+         */
+        class JsonPath
+        {
+            friend class JsonFind;
+            friend class JsonCursor;
+            friend class JsonPush;
+
+            private:
+            vector<JsonPathStep> steps;
+
+            void compile     ( const string&, JsonEngines                  );
+            void compile_ptr ( const string&                               );
+            bool resolve     ( const JsonTape&, size_t&, size_t&, size_t   ) const;
+
+            public:
+            JsonPath(const string&, JsonEngines);
+            JsonPath(const string&, JsonPathSyntaxes);
+            JsonPath(const string&);
+            ~JsonPath(void);
+
+            size_t               size     ( void   ) const;
+            const JsonPathStep & get_step ( size_t ) const;
+        };
+    }
+#endif
@@ -0,0 +1,265 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "JsonProj.h"
+
+namespace JsonParse
+{
+    using namespace std;
+    using namespace SyscJson;
+
+    // =============================================================================
+    // Class JsonProj
+    // =============================================================================
+    JsonProj::JsonProj(const vector<JsonPath> & arg_paths) : paths(arg_paths), trie(nullptr)
+    {
+        for (size_t i = 0 ; i < this->paths.size() ; i++)
+        {
+            this->trie.add(this->paths[i], 0, i);
+        }
+
+        this->pend_key = false;
+        this->ign      = 0;
+        this->kept     = false;
+    }
+
+    JsonProj::~JsonProj(void) { }
+
+    /* The step of the node allows a value of the structural type */
+    bool
+    JsonProj::styp_ok(const JsonTrie * arg_node, JsonStructTypes arg_styp) const
+    {
+        return (arg_node->step->styp == json_styp_LAST) || (arg_node->step->styp == arg_styp);
+    }
+
+    /* Keep a value reached by the nodes, whole if the last argument is set
+     * or a path ends at any of them, opening a frame for an object or
+     * array
+     */
+    JsonProjActs
+    JsonProj::push(vector<const JsonTrie*> & arg_nodes, JsonStructTypes arg_styp, bool arg_all)
+    {
+        Frame tmp;
+
+        if ((arg_styp != json_styp_obj_bgn) && (arg_styp != json_styp_arr_bgn))
+        {
+            return proj_keep;
+        }
+
+        tmp.all  = arg_all;
+        tmp.obj  = (arg_styp == json_styp_obj_bgn);
+        tmp.item = 0;
+
+        for (const JsonTrie * node : arg_nodes)
+        {
+            tmp.all = tmp.all || (!node->ends.empty());
+        }
+
+        tmp.nodes.swap(arg_nodes);
+        this->stk.push_back(move(tmp));
+
+        return proj_keep;
+    }
+
+    /* The top-level object or array is always kept.  Within an object,
+     * the value of a dropped key is dropped; within an array, an item not
+     * reached by any step is emptied.  Steps taking items from the end of
+     * an array reach every item.  A value reached only by steps requiring
+     * another structural type is also emptied, as the steps fail on it.
+     */
+    JsonProjActs
+    JsonProj::decide(JsonStructTypes arg_styp)
+    {
+        vector<const JsonTrie*> tmp;
+
+        if (this->stk.empty())
+        {
+            for (auto & kid : this->trie.kids)
+            {
+                if ((kid->step->op == json_path_root) && (this->styp_ok(kid.get(), arg_styp)))
+                {
+                    tmp.push_back(kid.get());
+                }
+            }
+
+            return this->push(tmp, arg_styp, false);
+        }
+
+        Frame & frm = this->stk.back();
+
+        if (frm.all)
+        {
+            return this->push(tmp, arg_styp, true);
+        }
+
+        if (frm.obj)
+        {
+            if (!this->pend_key)
+            {
+                return proj_skip;
+            }
+
+            for (const JsonTrie * node : this->pend)
+            {
+                if (this->styp_ok(node, arg_styp))
+                {
+                    tmp.push_back(node);
+                }
+            }
+
+            this->pend.clear();
+            this->pend_key = false;
+        }
+        else
+        {
+            if (frm.nodes.empty())
+            {
+                return proj_skip;
+            }
+
+            for (const JsonTrie * node : frm.nodes)
+            {
+                for (auto & kid : node->kids)
+                {
+                    const JsonPathStep & step = *(kid->step);
+                    bool                 hit  = false;
+
+                    if (step.op == json_path_idx)
+                    {
+                        hit = step.from_end || (step.idx == frm.item);
+                    }
+                    else if (step.op == json_path_member)
+                    {
+                        hit = (step.idx == frm.item);
+                    }
+                    else if ((step.op == json_path_first) && (step.styp == arg_styp))
+                    {
+                        hit = (find(frm.done.begin(), frm.done.end(), kid.get()) == frm.done.end());
+
+                        if (hit)
+                        {
+                            frm.done.push_back(kid.get());
+                        }
+                    }
+
+                    if ((hit) && (this->styp_ok(kid.get(), arg_styp)))
+                    {
+                        tmp.push_back(kid.get());
+                    }
+                }
+            }
+
+            frm.item++;
+        }
+
+        if (tmp.empty())
+        {
+            return proj_empty;
+        }
+
+        return this->push(tmp, arg_styp, false);
+    }
+
+    /* A value of the structural type begins.  With the second argument
+     * set, the caller steps over the value itself unless it is kept, and
+     * the tokens it then passes for a kept value are not decided again.
+     */
+    JsonProjActs
+    JsonProj::put_val(JsonStructTypes arg_styp, bool arg_step)
+    {
+        bool         bgn = (arg_styp == json_styp_obj_bgn) || (arg_styp == json_styp_arr_bgn);
+        JsonProjActs act;
+
+        if (this->kept)
+        {
+            this->kept = false;
+            return proj_keep;
+        }
+
+        if (this->ign > 0)
+        {
+            this->ign += bgn ? 1 : 0;
+            return proj_skip;
+        }
+
+        act = this->decide(arg_styp);
+
+        if ((act != proj_keep) && (bgn) && (!arg_step))
+        {
+            this->ign = 1;
+        }
+
+        this->kept = (act == proj_keep) && (arg_step);
+
+        return act;
+    }
+
+    /* A key begins a member.  Returns true if the key is kept. */
+    bool
+    JsonProj::put_key(const char * arg_ptr, size_t arg_len)
+    {
+        if (this->ign > 0)
+        {
+            return false;
+        }
+
+        Frame & frm = this->stk.back();
+
+        if (frm.all)
+        {
+            return true;
+        }
+
+        this->pend.clear();
+
+        for (const JsonTrie * node : frm.nodes)
+        {
+            for (auto & kid : node->kids)
+            {
+                const string & key = kid->step->key;
+
+                if (((kid->step->op == json_path_key) || (kid->step->op == json_path_member)) && (key.size() == arg_len) && ((arg_len == 0) || (memcmp(key.data(), arg_ptr, arg_len) == 0)))
+                {
+                    this->pend.push_back(kid.get());
+                }
+            }
+        }
+
+        this->pend_key = !this->pend.empty();
+
+        return this->pend_key;
+    }
+
+    /* An object or array ends.  Returns true if the end is kept. */
+    bool
+    JsonProj::put_end(void)
+    {
+        if (this->ign > 0)
+        {
+            this->ign--;
+            return false;
+        }
+
+        this->stk.pop_back();
+
+        return true;
+    }
+}
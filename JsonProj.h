@@ -0,0 +1,92 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _JSON_PROJ_H_
+    #define _JSON_PROJ_H_
+
+    #include <vector>
+
+    #include "JsonToken.h"
+    #include "JsonPath.h"
+    #include "JsonTrie.h"
+
+    namespace JsonParse
+    {
+        using std::vector;
+        using std::size_t;
+        using SyscJson::JsonPath;
+        using SyscJson::JsonStructTypes;
+
+        /* What the parser does with a value */
+        enum JsonProjActs
+        {
+            proj_keep,   // put the value
+            proj_skip,   // drop the value
+            proj_empty   // put null, {} or [] in place of the value
+        };
+
+        /* Projection of parsed JSON onto a set of search paths
+         *
+         * Decides, token by token in document order, whether each token
+         * is kept.  The values selected by the paths are kept whole, as are
+         * the objects, arrays and keys leading to them; other keys and
+         * their values are dropped, and other array items are replaced by
+         * null or an empty object or array, as the item was a scalar,
+         * object or array, so that item indexes and structural types are
+         * unchanged.  The paths therefore select the same values in the
+         * projection as in the whole JSON.
+         *
+         * Parsers that can step over a value without decoding it ask
+         * first with put_val(), and others pass every token, those within
+         * a dropped value being ignored.
+         */
+        class JsonProj
+        {
+            private:
+            struct Frame
+            {
+                vector<const JsonTrie*> nodes;
+                vector<const JsonTrie*> done;
+                bool                    all;
+                bool                    obj;
+                size_t                  item;
+            };
+
+            vector<JsonPath>        paths;
+            JsonTrie                trie;
+            vector<Frame>           stk;
+            vector<const JsonTrie*> pend;
+            bool                    pend_key;
+            size_t                  ign;
+            bool                    kept;
+
+            JsonProjActs decide  ( JsonStructTypes                                 );
+            JsonProjActs push    ( vector<const JsonTrie*>&, JsonStructTypes, bool );
+            bool         styp_ok ( const JsonTrie*, JsonStructTypes                ) const;
+
+            public:
+            JsonProj(const vector<JsonPath>&);
+            ~JsonProj(void);
+
+            JsonProjActs put_val ( JsonStructTypes, bool                           );
+            bool         put_key ( const char*, size_t                             );
+            bool         put_end ( void                                            );
+        };
+    }
+#endif
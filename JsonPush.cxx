@@ -0,0 +1,653 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file  JsonPush.cxx
+ *  \brief Defines the JsonPush and JsonPushErr classes.
+ */
+
+#include <cstring>
+#include <JsonVec.h>
+#include <JsonScan.h>
+#include <JsonNum.h>
+#include <JsonPath.h>
+#include <JsonPush.h>
+
+namespace SyscJson
+{
+    using namespace std;
+    using namespace SyscMsg;
+    using namespace SyscMsg::Chars;
+    using namespace JsonParse;
+
+    /* No search target yet */
+    static const size_t push_none = ~size_t(0);
+
+    // =============================================================================
+    // Class JsonPushErr
+    // =============================================================================
+    /** \brief Constructor for JsonPushErr exception class
+     *
+     *  Argument string may be used to describe the exception.
+     *
+     */
+    JsonPushErr::JsonPushErr(string s)
+    {
+        this->err_msg = s;
+    }
+
+    /** \brief Destructor for JsonPushErr exception class
+     *
+     *  No-op.
+     *
+     */
+    JsonPushErr::~JsonPushErr(void)
+    {
+    }
+
+    /** \brief Accessor method for JsonPushErr exception message
+     *
+     *  Returns the message string.
+     *
+     */
+    string
+    JsonPushErr::get_msg(void)
+    {
+        return "JsonPushErr reports" + SP + this->err_msg;
+    }
+
+    // =============================================================================
+    // Class JsonPush
+    // =============================================================================
+    /** \brief Constructor for JsonPush debug instance
+     *
+     *  The string parameter specifies that debug messages are desired,
+     *  and is used to prefix all debug messages.
+     */
+    JsonPush::JsonPush(const string & arg_msgid)
+    {
+        this->msg   = unique_ptr<Msg>(new Msg(arg_msgid.c_str()));
+        this->vec   = unique_ptr<JsonVec>(new JsonVec());
+        this->gram  = unique_ptr<JsonGram>(new JsonGram(*(this->vec)));
+        this->state = push_wspc;
+        this->posn  = 0;
+        this->find  = find_off;
+    }
+
+    /** \brief Constructor for JsonPush non-debug instance
+     *
+     */
+    JsonPush::JsonPush(void)
+    {
+        this->msg   = unique_ptr<Msg>(nullptr);
+        this->vec   = unique_ptr<JsonVec>(new JsonVec());
+        this->gram  = unique_ptr<JsonGram>(new JsonGram(*(this->vec)));
+        this->state = push_wspc;
+        this->posn  = 0;
+        this->find  = find_off;
+    }
+
+    /** \brief Destructor for JsonPush
+     *
+     *   No-op.
+     */
+    JsonPush::~JsonPush(void) { }
+
+    /* Throws, reporting the position in the whole input */
+    void
+    JsonPush::err(const char * arg_msg)
+    {
+        string tmp = string(arg_msg) + SP + "at character" + SP + to_string(this->posn);
+
+        if (this->msg != nullptr) { this->msg->cerr_err(tmp); }
+
+        throw JsonPushErr("failure in JsonPush:" + SP + tmp);
+    }
+
+    /* Passes the completed number or literal in tok to the grammar */
+    void
+    JsonPush::put_scal(void)
+    {
+        bool ok;
+
+        if (this->tok == "null")
+        {
+            ok = this->gram->put_nul();
+        }
+        else if (this->tok == "true")
+        {
+            ok = this->gram->put_tru();
+        }
+        else if (this->tok == "false")
+        {
+            ok = this->gram->put_fal();
+        }
+        else if (json_is_number(this->tok.data(), this->tok.size()))
+        {
+            ok = this->gram->put_num(this->tok.data(), this->tok.size());
+        }
+        else
+        {
+            this->err("unrecognized value");
+            return;
+        }
+
+        if (!ok)
+        {
+            this->err("syntax error");
+        }
+    }
+
+    /* Advances the lexer state by one character */
+    void
+    JsonPush::put_char(char c)
+    {
+        bool ok = true;
+
+        this->posn++;
+
+        if (this->state == push_scal)
+        {
+            if ((!json_is_wspc(c)) && (!json_is_struc(c)) && (c != '"'))
+            {
+                this->tok.push_back(c);
+                return;
+            }
+
+            this->put_scal();
+            this->state = push_wspc;
+        }
+
+        switch (this->state)
+        {
+            case push_wspc :
+            {
+                if (json_is_wspc(c))
+                {
+                    return;
+                }
+
+                if (this->gram->is_done())
+                {
+                    this->err("unexpected character after end of JSON");
+                }
+
+                switch (c)
+                {
+                    case '{' : ok = this->gram->put_obj_bgn(); break;
+                    case '}' : ok = this->gram->put_obj_end(); break;
+                    case '[' : ok = this->gram->put_arr_bgn(); break;
+                    case ']' : ok = this->gram->put_arr_end(); break;
+                    case ':' : ok = this->gram->put_colon();   break;
+                    case ',' : ok = this->gram->put_comma();   break;
+                    case '"' :
+                    {
+                        this->tok.clear();
+                        this->state = push_str;
+                        break;
+                    }
+                    default :
+                    {
+                        this->tok.assign(1, c);
+                        this->state = push_scal;
+                        break;
+                    }
+                }
+
+                break;
+            }
+            case push_str :
+            {
+                if (c == '"')
+                {
+                    ok = this->gram->put_str(this->tok.data(), this->tok.size());
+                    this->state = push_wspc;
+                }
+                else if (c == '\\')
+                {
+                    this->state = push_esc;
+                }
+                else
+                {
+                    this->tok.push_back(c);
+                }
+
+                break;
+            }
+            case push_esc :
+            {
+                this->state = push_str;
+
+                switch (c)
+                {
+                    case '"'  : this->tok.push_back('"');  break;
+                    case '/'  : this->tok.push_back('/');  break;
+                    case '\\' : this->tok.push_back('\\'); break;
+                    case 'b'  : this->tok.push_back('\b'); break;
+                    case 't'  : this->tok.push_back('\t'); break;
+                    case 'f'  : this->tok.push_back('\f'); break;
+                    case 'n'  : this->tok.push_back('\n'); break;
+                    case 'r'  : this->tok.push_back('\r'); break;
+                    case 'u'  :
+                    {
+                        this->uni.assign("\\u");
+                        this->state = push_uni;
+                        break;
+                    }
+                    default :
+                    {
+                        this->err("bad escape");
+                    }
+                }
+
+                break;
+            }
+            case push_uni :
+            {
+                if (json_hex_val(c) < 0)
+                {
+                    this->err("bad unicode escape");
+                }
+
+                this->uni.push_back(c);
+
+                if (this->uni.size() == 6)
+                {
+                    unsigned code = 0;
+
+                    for (size_t i = 2 ; i < 6 ; i++)
+                    {
+                        code = (code << 4) | json_hex_val(this->uni[i]);
+                    }
+
+                    json_put_uni(this->tok, code);
+                    this->state = push_str;
+                }
+
+                break;
+            }
+            default : break;
+        }
+
+        if (!ok)
+        {
+            this->err("syntax error");
+        }
+    }
+
+    /* Follows the search path over the tokens completed since the last
+     * call
+     */
+    void
+    JsonPush::put_find(void)
+    {
+        JsonTape & tape = this->vec->get_tape();
+        size_t     idx;
+
+        while ((this->find == find_busy) && (this->seen < tape.size()))
+        {
+            idx        = this->seen;
+            this->seen = tape.next(idx);
+            this->find_tok(tape, idx);
+        }
+
+        if (this->find == find_missing)
+        {
+            if (this->msg != nullptr) { this->msg->cerr_inf("find:" +TB+ "no match at character" +SP+ to_string(this->posn)); }
+
+            this->vec->clr_tape();
+        }
+    }
+
+    /* The items of the object or array searched by the next step are at
+     * depth cdep, counting the objects and arrays open before each token
+     */
+    void
+    JsonPush::find_tok(JsonTape & arg_tape, size_t arg_idx)
+    {
+        JsonStructTypes styp = arg_tape.get_styp(arg_idx);
+
+        if ((styp == json_styp_obj_end) || (styp == json_styp_arr_end))
+        {
+            this->depth--;
+            this->find_end(arg_tape, arg_idx);
+            return;
+        }
+
+        if ((this->depth == this->cdep) && (this->tgt == push_none))
+        {
+            this->find_item(arg_tape, arg_idx);
+        }
+
+        if ((styp == json_styp_obj_bgn) || (styp == json_styp_arr_bgn))
+        {
+            this->depth++;
+        }
+    }
+
+    /* Matches a key or item of the object or array searched against the
+     * next step, as JsonPath::resolve() does, descending into the item or
+     * taking it as the target
+     */
+    void
+    JsonPush::find_item(JsonTape & arg_tape, size_t arg_idx)
+    {
+        const JsonPathStep & step = this->path->get_step(this->step);
+        JsonStructTypes      styp = arg_tape.get_styp(arg_idx);
+        bool                 obj  = (arg_tape.get_styp(this->cbgn) == json_styp_obj_bgn);
+        bool                 hit  = false;
+
+        if (styp == json_styp_key)
+        {
+            if (((step.op == json_path_key) || (step.op == json_path_member)) && (this->kidx == 0) && (arg_tape.cmp_str(arg_idx, step.key.data(), step.key.size())))
+            {
+                this->kidx = arg_idx;
+            }
+
+            return;
+        }
+
+        switch (step.op)
+        {
+            case json_path_root   : hit = true;                                                   break;
+            case json_path_key    : hit = (this->kidx != 0);                                      break;
+            case json_path_idx    : hit = (!step.from_end) && (this->item++ == step.idx);         break;
+            case json_path_first  : hit = (styp == step.styp);                                    break;
+            case json_path_member : hit = obj ? (this->kidx != 0) : (this->item++ == step.idx);   break;
+            default               : this->find = find_missing;                                    return;
+        }
+
+        if (!hit)
+        {
+            return;
+        }
+
+        if ((step.styp != json_styp_LAST) && (styp != step.styp))
+        {
+            this->find = find_missing;
+            return;
+        }
+
+        this->step++;
+
+        if (this->step == this->path->size())
+        {
+            this->tgt  = step.sel_key ? this->kidx : arg_idx;
+            this->tdep = this->depth;
+
+            if ((styp != json_styp_obj_bgn) && (styp != json_styp_arr_bgn))
+            {
+                this->set_found(arg_tape, this->tgt, arg_tape.next(arg_idx), step.sel_key);
+            }
+
+            return;
+        }
+
+        switch (this->path->get_step(this->step).op)
+        {
+            case json_path_key    : hit = (styp == json_styp_obj_bgn);                                 break;
+            case json_path_idx    : hit = (styp == json_styp_arr_bgn);                                 break;
+            case json_path_first  : hit = (styp == json_styp_arr_bgn);                                 break;
+            case json_path_member : hit = (styp == json_styp_obj_bgn) || (styp == json_styp_arr_bgn);  break;
+            default               : hit = false;                                                       break;
+        }
+
+        if (!hit)
+        {
+            this->find = find_missing;
+            return;
+        }
+
+        this->cbgn = arg_idx;
+        this->cdep = this->depth + 1;
+        this->item = 0;
+        this->kidx = 0;
+    }
+
+    /* Completes an object or array target, or ends the search when the
+     * object or array searched ends.  Items counted from the end of an
+     * array are only known then, so the rest of the path is resolved
+     * within it.
+     */
+    void
+    JsonPush::find_end(JsonTape & arg_tape, size_t arg_idx)
+    {
+        bool   sel = this->path->get_step(this->path->size() - 1).sel_key;
+        size_t dit = this->cbgn;
+        size_t kit = 0;
+
+        if (this->tgt != push_none)
+        {
+            if (this->depth == this->tdep)
+            {
+                this->set_found(arg_tape, this->tgt, arg_idx + 1, sel);
+            }
+
+            return;
+        }
+
+        if (this->depth + 1 != this->cdep)
+        {
+            return;
+        }
+
+        if ((this->path->get_step(this->step).from_end) && (this->path->resolve(arg_tape, dit, kit, this->step)))
+        {
+            this->set_found(arg_tape, sel ? kit : dit, arg_tape.skip(dit), sel);
+            return;
+        }
+
+        this->find = find_missing;
+    }
+
+    /* Keeps only the target tokens, within an object for a selected key */
+    void
+    JsonPush::set_found(JsonTape & arg_tape, size_t arg_bgn, size_t arg_end, bool arg_key)
+    {
+        if (this->msg != nullptr) { this->msg->cerr_inf("find:" +TB+ "match at character" +SP+ to_string(this->posn)); }
+
+        this->vec->keep_tape(arg_bgn, arg_end, arg_key);
+        this->find = find_found;
+    }
+
+    /** \brief Search for one value while parsing
+     *
+     *  The search path argument is followed as the following chunks are
+     *  parsed, and parsing stops once the value it selects is complete,
+     *  or is known to be missing.  Must be called before the first chunk.
+     */
+    void
+    JsonPush::set_search_path(const JsonPath & arg_path)
+    {
+        if (this->posn != 0)
+        {
+            this->err("search path set after input");
+        }
+
+        this->path  = unique_ptr<JsonPath>(new JsonPath(arg_path));
+        this->find  = find_busy;
+        this->seen  = 0;
+        this->step  = 0;
+        this->depth = 0;
+        this->cdep  = 0;
+        this->cbgn  = 0;
+        this->item  = 0;
+        this->kidx  = 0;
+        this->tgt   = push_none;
+        this->tdep  = 0;
+    }
+
+    /** \brief Parse the next chunk of a JSON string
+     *
+     *  Tokens completed by the chunk are appended to those waiting for
+     *  get_tokens().  Throws JsonPushErr on a parsing error, after which
+     *  the instance may not be used.
+     *
+     *  When searching, the chunk is read only up to the end of the search,
+     *  and later chunks are ignored.
+     */
+    void
+    JsonPush::put_chunk(const char * arg_ptr, size_t arg_len)
+    {
+        const char * p = arg_ptr;
+        const char * e = arg_ptr + arg_len;
+
+        if ((this->find == find_found) || (this->find == find_missing))
+        {
+            return;
+        }
+
+        while (p != e)
+        {
+            // bulk copy of string characters
+            if (this->state == push_str)
+            {
+                const char * q = p;
+
+                while ((q != e) && (*q != '"') && (*q != '\\'))
+                {
+                    q++;
+                }
+
+                this->tok.append(p, q - p);
+                this->posn += q - p;
+                p = q;
+
+                if (p == e)
+                {
+                    break;
+                }
+            }
+
+            this->put_char(*p);
+            p++;
+
+            if (this->find == find_busy)
+            {
+                this->put_find();
+
+                if (this->find != find_busy)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    /** \brief Parse the next chunk of a JSON string
+     *
+     *  As put_chunk(const char*, size_t).
+     */
+    void
+    JsonPush::put_chunk(const string & arg_str)
+    {
+        this->put_chunk(arg_str.data(), arg_str.size());
+    }
+
+    /** \brief Mark the end of the JSON string
+     *
+     *  Completes a trailing token, and throws JsonPushErr unless a whole
+     *  JSON object or array has been parsed.  Does nothing once a search
+     *  has ended.
+     */
+    void
+    JsonPush::put_end(void)
+    {
+        if ((this->find == find_found) || (this->find == find_missing))
+        {
+            return;
+        }
+
+        if (this->state == push_scal)
+        {
+            this->put_scal();
+            this->state = push_wspc;
+        }
+
+        if (this->state != push_wspc)
+        {
+            this->err("unterminated string");
+        }
+
+        if (!this->gram->is_done())
+        {
+            this->err("unexpected end of JSON");
+        }
+
+        if (this->find == find_busy)
+        {
+            this->put_find();
+        }
+    }
+
+    /** \brief Check for a completed search
+     *
+     *  Returns true once the value selected by the search path is
+     *  complete.
+     */
+    bool
+    JsonPush::is_found(void) const
+    {
+        return this->find == find_found;
+    }
+
+    /** \brief Check for a failed search
+     *
+     *  Returns true once the search path is known to select nothing.
+     */
+    bool
+    JsonPush::is_missing(void) const
+    {
+        return this->find == find_missing;
+    }
+
+    /** \brief Check for completed tokens
+     *
+     *  Returns true if get_tokens() has tokens to return.  While
+     *  searching, no tokens are returned until the search has ended.
+     */
+    bool
+    JsonPush::has_tokens(void) const
+    {
+        if (this->find == find_busy)
+        {
+            return false;
+        }
+
+        return !this->vec->get_tape().empty();
+    }
+
+    /** \brief Take the completed tokens
+     *
+     *  The argument is loaded with the tokens completed since the last
+     *  call, which are then released by the parser.  While searching, it
+     *  is loaded with the tokens of the selected value once found.
+     */
+    void
+    JsonPush::get_tokens(Tokens & arg_tok)
+    {
+        if (this->find == find_busy)
+        {
+            arg_tok.clear();
+            return;
+        }
+
+        this->vec->get_tape().get_tokens(arg_tok);
+        this->vec->clr_tape();
+    }
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file  JsonPush.h
+ *  \brief Declares the JsonPush and JsonPushErr classes.
+ */
+
+#ifndef _JSON_PUSH_H_
+    #define _JSON_PUSH_H_
+
+    #include <memory>
+    #include <string>
+    #include <SyscMsg.h>
+    #include <JsonToken.h>
+
+    namespace JsonParse
+    {
+        class JsonVec;
+        class JsonGram;
+    }
+
+    namespace SyscJson
+    {
+        class JsonTape;
+        class JsonPath;
+        class JsonFind;
+
+        using SyscMsg::Msg;
+        using std::unique_ptr;
+        using std::string;
+        using std::size_t;
+
+        /** \class JsonPushErr
+         *  \brief Exception class for JsonPush
+         *
+         *  This class is thrown by the JsonPush::put_chunk() and
+         *  JsonPush::put_end() methods in the event of a JSON parsing
+         *  error.
+         *
+         *  The err_msg string is set in the constructor and may be
+         *  used to indicate why the exception was thrown.  It is
+         *  accessed by the get_msg() method.
+         */
+        /** \var   JsonPushErr::err_msg
+         *  \brief String data for exception message
+         */
+        class JsonPushErr
+        {
+            public:
+            string err_msg;
+
+            JsonPushErr(string);
+            ~JsonPushErr(void);
+
+            string get_msg(void);
+        };
+
+        /** \class JsonPush
+         *  \brief Incremental JSON parser for streamed input.
+         *
+         *  <h2 class="mp">Methods</h2>
+         *
+         *  The put_chunk() method parses the next piece of a JSON string.
+         *  Chunks may be of any size and may split tokens anywhere; a
+         *  partial token is held until the chunk that completes it.
+         *
+         *  The get_tokens() method moves the tokens completed so far out
+         *  of the parser.  Memory use is bounded by the chunk size, the
+         *  partial token and the tokens not yet taken.
+         *
+         *  The put_end() method marks the end of input and checks that a
+         *  complete JSON object or array was seen.
+         *
+         *  The tokens are the same as those produced by
+         *  JsonFind::set_search_context() for the whole JSON string, in
+         *  the json_tmod_copy token mode.
+         *
+         *  <h2 class="mp">Streaming Search</h2>
+         *
+         *  The set_search_path() method turns the parser into a search for
+         *  one value.  The path is followed as tokens are parsed, and once
+         *  the selected value is complete, or the object or array that
+         *  should hold it has ended, put_chunk() stops reading and the rest
+         *  of the input is neither parsed nor checked.  The is_found() and
+         *  is_missing() methods report the outcome, and get_tokens() then
+         *  returns the tokens of the selected value alone.  For a path
+         *  selecting a key, they are the tokens of an object holding only
+         *  that key and its value.
+         *
+         *  A search for a value near the start of a large JSON string so
+         *  costs the input up to the end of the value, not the whole
+         *  string.  A path with a negative array index must wait for the
+         *  end of the array.
+         */
+        class JsonPush
+        {
+            friend class JsonFind;
+
+            private:
+            enum PushStates
+            {
+                push_wspc,     // between tokens
+                push_str,      // in a string
+                push_esc,      // after a backslash in a string
+                push_uni,      // in the hex digits of a \u escape
+                push_scal      // in a number or literal
+            };
+
+            enum FindStates
+            {
+                find_off,      // not searching
+                find_busy,     // following the search path
+                find_found,    // the selected value is complete
+                find_missing   // the search path selects nothing
+            };
+
+            unique_ptr<Msg>                 msg;
+            unique_ptr<JsonParse::JsonVec>  vec;
+            unique_ptr<JsonParse::JsonGram> gram;
+            PushStates                      state;
+            string                          tok;
+            string                          uni;
+            size_t                          posn;
+            unique_ptr<JsonPath>            path;
+            FindStates                      find;
+            size_t                          seen;
+            size_t                          step;
+            size_t                          depth;
+            size_t                          cdep;
+            size_t                          cbgn;
+            size_t                          item;
+            size_t                          kidx;
+            size_t                          tgt;
+            size_t                          tdep;
+
+            void put_scal  ( void                             );
+            void put_char  ( char                             );
+            void put_find  ( void                             );
+            void find_tok  ( JsonTape&, size_t                );
+            void find_item ( JsonTape&, size_t                );
+            void find_end  ( JsonTape&, size_t                );
+            void set_found ( JsonTape&, size_t, size_t, bool  );
+            void err       ( const char*                      );
+
+            public:
+            JsonPush(const string&);
+            JsonPush(void);
+            ~JsonPush(void);
+
+            void set_search_path ( const JsonPath&     );
+            void put_chunk       ( const char*, size_t );
+            void put_chunk       ( const string&       );
+            void put_end         ( void                );
+            bool is_found        ( void                ) const;
+            bool is_missing      ( void                ) const;
+            bool has_tokens      ( void                ) const;
+            void get_tokens      ( Tokens&             );
+        };
+    }
+#endif
@@ -0,0 +1,1084 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+    #define JSON_SCAN_X86 1
+#else
+    #define JSON_SCAN_X86 0
+#endif
+
+#include "JsonVec.h"
+#include "JsonScan.h"
+#include "JsonNum.h"
+
+namespace JsonParse
+{
+    using namespace std;
+    using namespace SyscJson;
+
+    // =============================================================================
+    // Kernels
+    // =============================================================================
+    static void
+    kern_scal(const char * p, JsonScanMasks & m)
+    {
+        m.quote  = 0;
+        m.bslash = 0;
+        m.struc  = 0;
+        m.wspc   = 0;
+
+        for (int i = 0 ; i < 64 ; i++)
+        {
+            uint64_t bit = uint64_t(1) << i;
+
+            if (p[i] == '"')  m.quote  |= bit;
+            if (p[i] == '\\') m.bslash |= bit;
+            if (json_is_struc(p[i])) m.struc  |= bit;
+            if (json_is_wspc(p[i]))  m.wspc   |= bit;
+        }
+    }
+
+#if JSON_SCAN_X86
+    __attribute__((target("sse4.2")))
+    static inline uint64_t
+    sse42_any(__m128i set, int set_len, const char * p)
+    {
+        uint64_t ret = 0;
+
+        for (int i = 0 ; i < 4 ; i++)
+        {
+            __m128i blk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+            __m128i hit = _mm_cmpestrm(set, set_len, blk, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK);
+
+            ret |= uint64_t(uint16_t(_mm_cvtsi128_si32(hit))) << (16 * i);
+        }
+
+        return ret;
+    }
+
+    __attribute__((target("sse4.2")))
+    static inline uint64_t
+    sse42_eq(char c, const char * p)
+    {
+        __m128i  chr = _mm_set1_epi8(c);
+        uint64_t ret = 0;
+
+        for (int i = 0 ; i < 4 ; i++)
+        {
+            __m128i blk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+
+            ret |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(blk, chr)))) << (16 * i);
+        }
+
+        return ret;
+    }
+
+    __attribute__((target("sse4.2")))
+    static void
+    kern_sse42(const char * p, JsonScanMasks & m)
+    {
+        const __m128i struc = _mm_setr_epi8('{', '}', '[', ']', ':', ',', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m128i wspc  = _mm_setr_epi8(' ', '\t', '\n', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+        m.quote  = sse42_eq('"', p);
+        m.bslash = sse42_eq('\\', p);
+        m.struc  = sse42_any(struc, 6, p);
+        m.wspc   = sse42_any(wspc, 3, p);
+    }
+
+    __attribute__((target("avx2")))
+    static inline uint64_t
+    avx2_eq(__m256i lo, __m256i hi, char c)
+    {
+        __m256i  chr = _mm256_set1_epi8(c);
+        uint64_t l   = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, chr)));
+        uint64_t h   = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, chr)));
+
+        return l | (h << 32);
+    }
+
+    __attribute__((target("avx2")))
+    static void
+    kern_avx2(const char * p, JsonScanMasks & m)
+    {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+
+        m.quote  = avx2_eq(lo, hi, '"');
+        m.bslash = avx2_eq(lo, hi, '\\');
+        m.struc  = avx2_eq(lo, hi, '{') | avx2_eq(lo, hi, '}')
+                 | avx2_eq(lo, hi, '[') | avx2_eq(lo, hi, ']')
+                 | avx2_eq(lo, hi, ':') | avx2_eq(lo, hi, ',');
+        m.wspc   = avx2_eq(lo, hi, ' ') | avx2_eq(lo, hi, '\t') | avx2_eq(lo, hi, '\n');
+    }
+#endif
+
+    static JsonScanKern
+    kern_select(void)
+    {
+#if JSON_SCAN_X86
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return kern_avx2;
+        }
+
+        if (__builtin_cpu_supports("sse4.2"))
+        {
+            return kern_sse42;
+        }
+#endif
+        return kern_scal;
+    }
+
+    /* String escaping kernels: the length of the prefix of at most the
+     * given length holding no quote, backslash or control character, nor
+     * any byte above 0x7F when the last argument is set
+     */
+    typedef size_t (*JsonSpanKern)(const char*, size_t, bool);
+
+    static size_t
+    span_scal(const char * p, size_t n, bool arg_ascii)
+    {
+        const unsigned char * q = reinterpret_cast<const unsigned char*>(p);
+        size_t                i = 0;
+
+        for ( ; i < n ; i++)
+        {
+            if ((q[i] < 0x20) || (q[i] == '"') || (q[i] == '\\') || ((arg_ascii) && (q[i] > 0x7F)))
+            {
+                break;
+            }
+        }
+
+        return i;
+    }
+
+#if JSON_SCAN_X86
+    __attribute__((target("sse4.2")))
+    static size_t
+    span_sse42(const char * p, size_t n, bool arg_ascii)
+    {
+        const __m128i quote  = _mm_set1_epi8('"');
+        const __m128i bslash = _mm_set1_epi8('\\');
+        const __m128i ctrl   = _mm_set1_epi8(0x1F);
+        size_t        i      = 0;
+
+        for ( ; i + 16 <= n ; i += 16)
+        {
+            __m128i blk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(blk, quote), _mm_cmpeq_epi8(blk, bslash));
+            int     msk;
+
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_max_epu8(blk, ctrl), ctrl));
+            msk = _mm_movemask_epi8(hit) | (arg_ascii ? _mm_movemask_epi8(blk) : 0);
+
+            if (msk != 0)
+            {
+                return i + __builtin_ctz(msk);
+            }
+        }
+
+        return i + span_scal(p + i, n - i, arg_ascii);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t
+    span_avx2(const char * p, size_t n, bool arg_ascii)
+    {
+        const __m256i quote  = _mm256_set1_epi8('"');
+        const __m256i bslash = _mm256_set1_epi8('\\');
+        const __m256i ctrl   = _mm256_set1_epi8(0x1F);
+        size_t        i      = 0;
+
+        for ( ; i + 32 <= n ; i += 32)
+        {
+            __m256i  blk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            __m256i  hit = _mm256_or_si256(_mm256_cmpeq_epi8(blk, quote), _mm256_cmpeq_epi8(blk, bslash));
+            uint32_t msk;
+
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(_mm256_max_epu8(blk, ctrl), ctrl));
+            msk = uint32_t(_mm256_movemask_epi8(hit)) | (arg_ascii ? uint32_t(_mm256_movemask_epi8(blk)) : 0);
+
+            if (msk != 0)
+            {
+                return i + __builtin_ctz(msk);
+            }
+        }
+
+        return i + span_sse42(p + i, n - i, arg_ascii);
+    }
+#endif
+
+    static JsonSpanKern
+    span_select(void)
+    {
+#if JSON_SCAN_X86
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return span_avx2;
+        }
+
+        if (__builtin_cpu_supports("sse4.2"))
+        {
+            return span_sse42;
+        }
+#endif
+        return span_scal;
+    }
+
+    /* Inclusive prefix XOR: bit N is the parity of bits 0..N */
+    static inline uint64_t
+    prefix_xor(uint64_t x)
+    {
+        x ^= x << 1;
+        x ^= x << 2;
+        x ^= x << 4;
+        x ^= x << 8;
+        x ^= x << 16;
+        x ^= x << 32;
+
+        return x;
+    }
+
+    // =============================================================================
+    // Class JsonGram
+    // =============================================================================
+    JsonGram::JsonGram(JsonVec & arg_vec) : vec(arg_vec)
+    {
+        this->state = gram_top;
+    }
+
+    JsonGram::~JsonGram(void) { }
+
+    bool
+    JsonGram::put_val(void)
+    {
+        switch (this->state)
+        {
+            case gram_val_or_end : break;
+            case gram_val        : break;
+            default              : return false;
+        }
+
+        this->state = gram_next;
+
+        return true;
+    }
+
+    bool
+    JsonGram::put_end(char arg_bgn)
+    {
+        if (this->stk.empty() || (this->stk.back() != arg_bgn))
+        {
+            return false;
+        }
+
+        this->stk.pop_back();
+        this->state = this->stk.empty() ? gram_done : gram_next;
+
+        return true;
+    }
+
+    bool
+    JsonGram::put_obj_bgn(void)
+    {
+        if ((this->state != gram_top) && (!this->put_val()))
+        {
+            return false;
+        }
+
+        this->stk.push_back('{');
+        this->state = gram_key_or_end;
+        this->vec.set_obj_bgn();
+
+        return true;
+    }
+
+    bool
+    JsonGram::put_obj_end(void)
+    {
+        switch (this->state)
+        {
+            case gram_key_or_end : break;
+            case gram_next       : break;
+            default              : return false;
+        }
+
+        if (!this->put_end('{'))
+        {
+            return false;
+        }
+
+        this->vec.set_obj_end();
+
+        return true;
+    }
+
+    bool
+    JsonGram::put_arr_bgn(void)
+    {
+        if ((this->state != gram_top) && (!this->put_val()))
+        {
+            return false;
+        }
+
+        this->stk.push_back('[');
+        this->state = gram_val_or_end;
+        this->vec.set_arr_bgn();
+
+        return true;
+    }
+
+    bool
+    JsonGram::put_arr_end(void)
+    {
+        switch (this->state)
+        {
+            case gram_val_or_end : break;
+            case gram_next       : break;
+            default              : return false;
+        }
+
+        if (!this->put_end('['))
+        {
+            return false;
+        }
+
+        this->vec.set_arr_end();
+
+        return true;
+    }
+
+    bool
+    JsonGram::put_colon(void)
+    {
+        if (this->state != gram_colon)
+        {
+            return false;
+        }
+
+        this->state = gram_val;
+
+        return true;
+    }
+
+    bool
+    JsonGram::put_comma(void)
+    {
+        if (this->state != gram_next)
+        {
+            return false;
+        }
+
+        this->state = (this->stk.back() == '{') ? gram_key : gram_val;
+
+        return true;
+    }
+
+    bool
+    JsonGram::put_str(const char * arg_ptr, size_t arg_len)
+    {
+        if ((this->state == gram_key_or_end) || (this->state == gram_key))
+        {
+            this->state = gram_colon;
+            this->vec.set_obj_key(arg_ptr, arg_len);
+
+            return true;
+        }
+
+        if (!this->put_val())
+        {
+            return false;
+        }
+
+        this->vec.set_elem_str(arg_ptr, arg_len);
+
+        return true;
+    }
+
+    bool
+    JsonGram::put_str_src(size_t arg_off, size_t arg_len)
+    {
+        if ((this->state == gram_key_or_end) || (this->state == gram_key))
+        {
+            this->state = gram_colon;
+            this->vec.set_obj_key_src(arg_off, arg_len);
+
+            return true;
+        }
+
+        if (!this->put_val())
+        {
+            return false;
+        }
+
+        this->vec.set_elem_str_src(arg_off, arg_len);
+
+        return true;
+    }
+
+    bool
+    JsonGram::put_num(const char * arg_ptr, size_t arg_len)
+    {
+        if (!this->put_val())
+        {
+            return false;
+        }
+
+        this->vec.set_elem_num(arg_ptr, arg_len);
+
+        return true;
+    }
+
+    bool
+    JsonGram::put_num_src(size_t arg_off, size_t arg_len)
+    {
+        if (!this->put_val())
+        {
+            return false;
+        }
+
+        this->vec.set_elem_num_src(arg_off, arg_len);
+
+        return true;
+    }
+
+    bool
+    JsonGram::put_nul(void)
+    {
+        if (!this->put_val())
+        {
+            return false;
+        }
+
+        this->vec.set_elem_nul();
+
+        return true;
+    }
+
+    bool
+    JsonGram::put_tru(void)
+    {
+        if (!this->put_val())
+        {
+            return false;
+        }
+
+        this->vec.set_elem_tru();
+
+        return true;
+    }
+
+    bool
+    JsonGram::put_fal(void)
+    {
+        if (!this->put_val())
+        {
+            return false;
+        }
+
+        this->vec.set_elem_fal();
+
+        return true;
+    }
+
+    bool
+    JsonGram::is_done(void) const
+    {
+        return this->state == gram_done;
+    }
+
+    /* A value within an object or array is expected */
+    bool
+    JsonGram::is_val(void) const
+    {
+        return (this->state == gram_val_or_end) || (this->state == gram_val);
+    }
+
+    /* A value was stepped over without passing its tokens on */
+    bool
+    JsonGram::put_skip(void)
+    {
+        return this->put_val();
+    }
+
+    // =============================================================================
+    // Scalar helpers
+    // =============================================================================
+    /* Length of the prefix of the string argument that needs no escaping
+     * in a JSON string, the last argument requiring ASCII output
+     */
+    size_t
+    json_esc_span(const char * p, size_t n, bool arg_ascii)
+    {
+        static const JsonSpanKern span_best = span_select();
+
+        return span_best(p, n, arg_ascii);
+    }
+
+    /* Code point of the UTF-8 sequence at the start of the string
+     * argument, setting the length argument to the bytes it takes, or
+     * 0xFFFD for one byte that does not start a valid sequence
+     */
+    static unsigned
+    json_get_utf8(const unsigned char * q, size_t n, size_t & arg_len)
+    {
+        unsigned code;
+        unsigned lo;
+        size_t   len;
+
+        if      ((q[0] >= 0xC2) && (q[0] <= 0xDF)) { len = 2; code = q[0] & 0x1Fu; lo = 0x80;    }
+        else if ((q[0] >= 0xE0) && (q[0] <= 0xEF)) { len = 3; code = q[0] & 0x0Fu; lo = 0x800;   }
+        else if ((q[0] >= 0xF0) && (q[0] <= 0xF4)) { len = 4; code = q[0] & 0x07u; lo = 0x10000; }
+        else                                       { arg_len = 1; return 0xFFFDu;                }
+
+        arg_len = 1;
+
+        if (n < len)
+        {
+            return 0xFFFDu;
+        }
+
+        for (size_t i = 1 ; i < len ; i++)
+        {
+            if ((q[i] & 0xC0u) != 0x80u)
+            {
+                return 0xFFFDu;
+            }
+
+            code = (code << 6) | (q[i] & 0x3Fu);
+        }
+
+        if ((code < lo) || (code > 0x10FFFFu) || ((code >= 0xD800u) && (code <= 0xDFFFu)))
+        {
+            return 0xFFFDu;
+        }
+
+        arg_len = len;
+        return code;
+    }
+
+    static char *
+    json_put_hex4(char * arg_out, unsigned code)
+    {
+        static const char hex[] = "0123456789abcdef";
+
+        arg_out[0] = '\\';
+        arg_out[1] = 'u';
+        arg_out[2] = hex[(code >> 12) & 0xFu];
+        arg_out[3] = hex[(code >> 8) & 0xFu];
+        arg_out[4] = hex[(code >> 4) & 0xFu];
+        arg_out[5] = hex[code & 0xFu];
+
+        return arg_out + 6;
+    }
+
+    /* Writes the escape sequence for the character at the start of the
+     * string argument, which json_esc_span() stopped at, to the output
+     * argument, which must hold json_esc_max characters, setting the
+     * length argument to the characters written.  Returns the bytes of
+     * the string argument taken.  With the ascii argument set, a
+     * character above U+007F is escaped as \uXXXX, or as a surrogate pair
+     * above U+FFFF, and bytes that are not valid UTF-8 as U+FFFD.
+     */
+    size_t
+    json_put_esc(char * arg_out, const char * p, size_t n, bool arg_ascii, size_t & arg_len)
+    {
+        const unsigned char * q   = reinterpret_cast<const unsigned char*>(p);
+        char                * out = arg_out;
+        unsigned              code;
+        size_t                len;
+
+        switch (q[0])
+        {
+            case '"'  : code = '"';  break;
+            case '\\' : code = '\\'; break;
+            case '\b' : code = 'b';  break;
+            case '\f' : code = 'f';  break;
+            case '\n' : code = 'n';  break;
+            case '\r' : code = 'r';  break;
+            case '\t' : code = 't';  break;
+            default   : code = 0;    break;
+        }
+
+        if (code != 0)
+        {
+            arg_out[0] = '\\';
+            arg_out[1] = static_cast<char>(code);
+            arg_len    = 2;
+            return 1;
+        }
+
+        if ((q[0] < 0x20) || (!arg_ascii))
+        {
+            arg_len = json_put_hex4(out, q[0]) - arg_out;
+            return 1;
+        }
+
+        code = json_get_utf8(q, n, len);
+
+        if (code > 0xFFFFu)
+        {
+            code -= 0x10000u;
+            out   = json_put_hex4(out, 0xD800u | (code >> 10));
+            out   = json_put_hex4(out, 0xDC00u | (code & 0x3FFu));
+        }
+        else
+        {
+            out = json_put_hex4(out, code);
+        }
+
+        arg_len = out - arg_out;
+        return len;
+    }
+
+    int
+    json_hex_val(char c)
+    {
+        if ((c >= '0') && (c <= '9')) return c - '0';
+        if ((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+        if ((c >= 'A') && (c <= 'F')) return c - 'A' + 10;
+        return -1;
+    }
+
+    // =============================================================================
+    // Class JsonScan
+    // =============================================================================
+    JsonScan::JsonScan(JsonVec & arg_vec, const char * arg_buf, size_t arg_len, JsonEngines arg_engn) : vec(arg_vec)
+    {
+        static const JsonScanKern kern_best = kern_select();
+
+        this->buf   = arg_buf;
+        this->len   = arg_len;
+        this->kern  = (arg_engn == json_engn_scal) ? kern_scal : kern_best;
+    }
+
+    JsonScan::~JsonScan(void) { }
+
+    void
+    JsonScan::err(const char * arg_msg, size_t arg_pos)
+    {
+        cerr << "parser error: \"" << arg_msg << "\" at character " << arg_pos << endl;
+    }
+
+    /* Stage one, fills idx with structural offsets */
+    bool
+    JsonScan::index(void)
+    {
+        const uint64_t even_bits = 0x5555555555555555ULL;
+
+        uint64_t prev_escaped = 0;
+        uint64_t prev_in_str  = 0;
+        uint64_t prev_scalar  = 0;
+        char     pad[64];
+
+        this->idx.clear();
+
+        for (size_t base = 0 ; base < this->len ; base += 64)
+        {
+            const char    * p = this->buf + base;
+            JsonScanMasks   m;
+
+            if (this->len - base < 64)
+            {
+                memset(pad, ' ', sizeof(pad));
+                memcpy(pad, p, this->len - base);
+                p = pad;
+            }
+
+            this->kern(p, m);
+
+            // characters preceded by an odd run of backslashes
+            uint64_t escaped;
+
+            if (m.bslash == 0)
+            {
+                escaped      = prev_escaped;
+                prev_escaped = 0;
+            }
+            else
+            {
+                uint64_t bs       = m.bslash & ~prev_escaped;
+                uint64_t bs_next  = (bs << 1) | prev_escaped;
+                uint64_t odd_bgn  = bs & ~even_bits & ~bs_next;
+                uint64_t even_seq = odd_bgn + bs;
+
+                prev_escaped = (even_seq < bs) ? 1 : 0;
+                escaped      = (even_bits ^ (even_seq << 1)) & bs_next;
+            }
+
+            // string interiors, including the opening but not the closing quote
+            uint64_t quote  = m.quote & ~escaped;
+            uint64_t in_str = prefix_xor(quote) ^ prev_in_str;
+
+            prev_in_str = uint64_t(int64_t(in_str) >> 63);
+
+            // first byte of each run of scalar characters
+            uint64_t scalar  = ~(m.struc | m.wspc | quote) & ~in_str;
+            uint64_t follows = (scalar << 1) | prev_scalar;
+
+            prev_scalar = scalar >> 63;
+
+            uint64_t bits = (m.struc & ~in_str) | (quote & in_str) | (scalar & ~follows);
+            size_t   cnt  = this->idx.size();
+
+            this->idx.resize(cnt + __builtin_popcountll(bits));
+
+            for (size_t * wp = this->idx.data() + cnt ; bits != 0 ; bits &= bits - 1)
+            {
+                *wp++ = base + __builtin_ctzll(bits);
+            }
+        }
+
+        if (prev_in_str)
+        {
+            this->err("unterminated string", this->len);
+            return false;
+        }
+
+        return true;
+    }
+
+    /* Appends the UTF-8 form of code to arg_str as concat_uni() does,
+     * whatever the codeset of the program
+     */
+    void
+    json_put_uni(string & arg_str, unsigned code)
+    {
+        if (code == 0)
+        {
+            // concat_char() drops NUL
+        }
+        else if (code < 0x80u)
+        {
+            arg_str.push_back(char(code));
+        }
+        else if (code < 0x800u)
+        {
+            arg_str.push_back(char(0xC0u | (code >> 6)));
+            arg_str.push_back(char(0x80u | (code & 0x3Fu)));
+        }
+        else
+        {
+            arg_str.push_back(char(0xE0u | (code >> 12)));
+            arg_str.push_back(char(0x80u | ((code >> 6) & 0x3Fu)));
+            arg_str.push_back(char(0x80u | (code & 0x3Fu)));
+        }
+    }
+
+    bool
+    JsonScan::get_uni(size_t arg_pos)
+    {
+        unsigned code = 0;
+
+        if (arg_pos + 6 > this->len)
+        {
+            return false;
+        }
+
+        for (size_t i = arg_pos + 2 ; i < arg_pos + 6 ; i++)
+        {
+            int hex = json_hex_val(this->buf[i]);
+
+            if (hex < 0)
+            {
+                return false;
+            }
+
+            code = (code << 4) | hex;
+        }
+
+        json_put_uni(this->tmp, code);
+
+        return true;
+    }
+
+    /* Finds the end of the string whose opening quote is at arg_pos,
+     * leaves arg_pos at the closing quote.  When the string contains
+     * escape sequences, arg_esc is set and the decoded string is in tmp.
+     */
+    bool
+    JsonScan::get_str(size_t & arg_pos, bool & arg_esc)
+    {
+        size_t pos = arg_pos + 1;
+        size_t run = pos;
+
+        arg_esc = false;
+
+        while (pos < this->len)
+        {
+            char c = this->buf[pos];
+
+            if (c == '"')
+            {
+                if (arg_esc)
+                {
+                    this->tmp.append(this->buf + run, pos - run);
+                }
+
+                arg_pos = pos;
+                return true;
+            }
+
+            if (c != '\\')
+            {
+                pos++;
+                continue;
+            }
+
+            if (!arg_esc)
+            {
+                this->tmp.clear();
+                arg_esc = true;
+            }
+
+            this->tmp.append(this->buf + run, pos - run);
+
+            if (pos + 1 >= this->len)
+            {
+                break;
+            }
+
+            switch (this->buf[pos + 1])
+            {
+                case '"'  : this->tmp.push_back('"');  break;
+                case '/'  : this->tmp.push_back('/');  break;
+                case '\\' : this->tmp.push_back('\\'); break;
+                case 'b'  : this->tmp.push_back('\b'); break;
+                case 't'  : this->tmp.push_back('\t'); break;
+                case 'f'  : this->tmp.push_back('\f'); break;
+                case 'n'  : this->tmp.push_back('\n'); break;
+                case 'r'  : this->tmp.push_back('\r'); break;
+                case 'u'  :
+                {
+                    if (!this->get_uni(pos))
+                    {
+                        this->err("bad unicode escape", pos);
+                        return false;
+                    }
+
+                    pos = pos + 4;
+                    break;
+                }
+                default :
+                {
+                    this->err("bad escape", pos);
+                    return false;
+                }
+            }
+
+            pos = pos + 2;
+            run = pos;
+        }
+
+        this->err("unterminated string", pos);
+        return false;
+    }
+
+    /* Stage two, walks idx and feeds the grammar */
+    bool
+    JsonScan::build(void)
+    {
+        JsonGram gram(this->vec);
+
+        for (size_t i = 0 ; i < this->idx.size() ; i++)
+        {
+            size_t pos = this->idx[i];
+            bool   ok;
+
+            if (gram.is_done())
+            {
+                this->err("unexpected character after end of JSON", pos);
+                return false;
+            }
+
+            this->vec.set_posn(pos);
+
+            if ((gram.is_val()) && (this->skip_val(i)))
+            {
+                if (!gram.put_skip())
+                {
+                    this->err("syntax error", pos);
+                    return false;
+                }
+
+                continue;
+            }
+
+            switch (this->buf[pos])
+            {
+                case '{' : ok = gram.put_obj_bgn(); break;
+                case '}' : ok = gram.put_obj_end(); break;
+                case '[' : ok = gram.put_arr_bgn(); break;
+                case ']' : ok = gram.put_arr_end(); break;
+                case ':' : ok = gram.put_colon();   break;
+                case ',' : ok = gram.put_comma();   break;
+                case '"' :
+                {
+                    size_t end = pos;
+                    bool   esc;
+
+                    if (!this->get_str(end, esc))
+                    {
+                        return false;
+                    }
+
+                    if (esc)
+                    {
+                        ok = gram.put_str(this->tmp.data(), this->tmp.size());
+                    }
+                    else
+                    {
+                        ok = gram.put_str_src(pos + 1, end - pos - 1);
+                    }
+
+                    break;
+                }
+                default :
+                {
+                    size_t end = pos;
+
+                    while ((end < this->len) && (!json_is_struc(this->buf[end])) && (!json_is_wspc(this->buf[end])) && (this->buf[end] != '"'))
+                    {
+                        end++;
+                    }
+
+                    const char * p = this->buf + pos;
+                    size_t       n = end - pos;
+
+                    if ((n == 4) && (memcmp(p, "null", 4) == 0))
+                    {
+                        ok = gram.put_nul();
+                    }
+                    else if ((n == 4) && (memcmp(p, "true", 4) == 0))
+                    {
+                        ok = gram.put_tru();
+                    }
+                    else if ((n == 5) && (memcmp(p, "false", 5) == 0))
+                    {
+                        ok = gram.put_fal();
+                    }
+                    else if (json_is_number(p, n))
+                    {
+                        ok = gram.put_num_src(pos, n);
+                    }
+                    else
+                    {
+                        this->err("unrecognized value", pos);
+                        return false;
+                    }
+
+                    break;
+                }
+            }
+
+            if (!ok)
+            {
+                this->err("syntax error", pos);
+                return false;
+            }
+        }
+
+        if (!gram.is_done())
+        {
+            this->err("unexpected end of JSON", this->len);
+            return false;
+        }
+
+        return true;
+    }
+
+    /* Steps over the value at the offset index argument if the JsonVec
+     * does not keep it, leaving the index at its last offset.  Strings
+     * and scalars are not decoded, and objects and arrays are passed over
+     * by counting brackets in the offsets, so their contents are checked
+     * only for balance.
+     */
+    bool
+    JsonScan::skip_val(size_t & arg_i)
+    {
+        JsonStructTypes styp;
+        size_t          lvl = 0;
+
+        switch (this->buf[this->idx[arg_i]])
+        {
+            case '{' : styp = json_styp_obj_bgn; break;
+            case '[' : styp = json_styp_arr_bgn; break;
+            case '}' : return false;
+            case ']' : return false;
+            case ':' : return false;
+            case ',' : return false;
+            default  : styp = json_styp_elem;    break;
+        }
+
+        if (!this->vec.skip_val(styp))
+        {
+            return false;
+        }
+
+        if (styp == json_styp_elem)
+        {
+            return true;
+        }
+
+        for ( ; arg_i < this->idx.size() ; arg_i++)
+        {
+            switch (this->buf[this->idx[arg_i]])
+            {
+                case '{' : lvl++; break;
+                case '[' : lvl++; break;
+                case '}' : lvl--; break;
+                case ']' : lvl--; break;
+                default  :        break;
+            }
+
+            if (lvl == 0)
+            {
+                return true;
+            }
+        }
+
+        return true;
+    }
+
+    /* Returns 0 on success, like json_parse() */
+    int
+    JsonScan::scan(void)
+    {
+        if (!this->index())
+        {
+            return 1;
+        }
+
+        if (!this->build())
+        {
+            return 1;
+        }
+
+        return 0;
+    }
+}
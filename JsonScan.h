@@ -0,0 +1,165 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _JSON_SCAN_H_
+    #define _JSON_SCAN_H_
+
+    #include <cstdint>
+    #include <string>
+    #include <vector>
+
+    #include "JsonToken.h"
+
+    namespace JsonParse
+    {
+        using std::string;
+        using std::vector;
+        using std::size_t;
+        using std::uint64_t;
+
+        class JsonVec;
+
+        /* Character classes, as in json_lex.l */
+        inline bool
+        json_is_wspc(char c)
+        {
+            return (c == ' ') || (c == '\t') || (c == '\n');
+        }
+
+        inline bool
+        json_is_struc(char c)
+        {
+            switch (c)
+            {
+                case '{' : return true;
+                case '}' : return true;
+                case '[' : return true;
+                case ']' : return true;
+                case ':' : return true;
+                case ',' : return true;
+                default  : return false;
+            }
+        }
+
+        /* Longest escape sequence written by json_put_esc() */
+        const size_t json_esc_max = 12;
+
+        size_t json_esc_span ( const char*, size_t, bool                 );
+        size_t json_put_esc  ( char*, const char*, size_t, bool, size_t& );
+        int    json_hex_val  ( char                                      );
+        void   json_put_uni  ( string&, unsigned                         );
+
+        /* Bit masks for one 64 byte block of input, bit N for byte N */
+        struct JsonScanMasks
+        {
+            uint64_t quote;
+            uint64_t bslash;
+            uint64_t struc;
+            uint64_t wspc;
+        };
+
+        typedef void (*JsonScanKern)(const char*, JsonScanMasks&);
+
+        /* JSON grammar checker
+         *
+         * Accepts structural events in document order, checks them
+         * against the same grammar as json_parse.y and forwards the
+         * resulting tokens to a JsonVec.
+         */
+        class JsonGram
+        {
+            private:
+            enum GramStates
+            {
+                gram_top,         // before the top-level object or array
+                gram_key_or_end,  // after '{'
+                gram_key,         // after ',' in an object
+                gram_colon,       // after a key
+                gram_val_or_end,  // after '['
+                gram_val,         // after ':' or after ',' in an array
+                gram_next,        // after a value
+                gram_done         // after the top-level object or array
+            };
+
+            JsonVec      & vec;
+            vector<char>   stk;
+            GramStates     state;
+
+            bool put_val  ( void );
+            bool put_end  ( char );
+
+            public:
+            JsonGram(JsonVec&);
+            ~JsonGram(void);
+
+            bool put_obj_bgn ( void                );
+            bool put_obj_end ( void                );
+            bool put_arr_bgn ( void                );
+            bool put_arr_end ( void                );
+            bool put_colon   ( void                );
+            bool put_comma   ( void                );
+            bool put_str     ( const char*, size_t );
+            bool put_str_src ( size_t, size_t      );
+            bool put_num     ( const char*, size_t );
+            bool put_num_src ( size_t, size_t      );
+            bool put_nul     ( void                );
+            bool put_tru     ( void                );
+            bool put_fal     ( void                );
+            bool is_done     ( void                ) const;
+            bool is_val      ( void                ) const;
+            bool put_skip    ( void                );
+        };
+
+        /* Structural-index JSON parser
+         *
+         * Stage one classifies the input 64 bytes at a time with SSE4.2
+         * or AVX2 kernels (or a scalar kernel) and records the offset of
+         * every structural character, opening quote and scalar start
+         * outside of strings.  Stage two walks the offsets, decodes the
+         * strings and scalars, and feeds a JsonGram.  Strings without escape
+         * sequences, and all numbers, are passed on as offsets into the
+         * input, which must therefore be the JsonVec source.  Values that a
+         * JsonVec projection does not keep are stepped over in stage two
+         * without being decoded.
+         */
+        class JsonScan
+        {
+            private:
+            JsonVec        & vec;
+            const char     * buf;
+            size_t           len;
+            JsonScanKern     kern;
+            vector<size_t>   idx;
+            string           tmp;
+
+            bool index     ( void                );
+            bool build     ( void                );
+            bool get_str   ( size_t&, bool&      );
+            bool get_uni   ( size_t              );
+            bool skip_val  ( size_t&             );
+            void err       ( const char*, size_t );
+
+            public:
+            JsonScan(JsonVec&, const char*, size_t, SyscJson::JsonEngines);
+            ~JsonScan(void);
+
+            int scan(void);
+        };
+    }
+#endif
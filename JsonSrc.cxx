@@ -0,0 +1,161 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "SyscMsg.h"
+#include "JsonSrc.h"
+
+namespace JsonParse
+{
+    using namespace std;
+    using namespace SyscMsg::Chars;
+
+    // =============================================================================
+    // Class JsonSrcErr
+    // =============================================================================
+    JsonSrcErr::JsonSrcErr(string s)
+    {
+        this->err_msg = s;
+    }
+
+    JsonSrcErr::~JsonSrcErr(void)
+    {
+    }
+
+    string
+    JsonSrcErr::get_msg(void)
+    {
+        return "JsonSrcErr reports" + SP + this->err_msg;
+    }
+
+    // =============================================================================
+    // Class JsonSrc
+    // =============================================================================
+    JsonSrc::JsonSrc(const string & arg_str)
+    {
+        this->txt     = arg_str;
+        this->map     = nullptr;
+        this->map_len = 0;
+        this->ptr     = this->txt.data();
+        this->len     = this->txt.size();
+    }
+
+    JsonSrc::JsonSrc(void)
+    {
+        this->map     = nullptr;
+        this->map_len = 0;
+        this->ptr     = this->txt.data();
+        this->len     = 0;
+    }
+
+    JsonSrc::~JsonSrc(void)
+    {
+        this->unmap();
+    }
+
+    void
+    JsonSrc::unmap(void)
+    {
+        if (this->map != nullptr)
+        {
+            munmap(this->map, this->map_len);
+            this->map     = nullptr;
+            this->map_len = 0;
+        }
+    }
+
+    /* Map the file read-only, an empty file is read as an empty string */
+    void
+    JsonSrc::set_file(const string & arg_path)
+    {
+        struct stat st;
+        int         fd;
+        void      * tmp;
+
+        fd = open(arg_path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (fd < 0)
+        {
+            throw JsonSrcErr("cannot open" + SP + DQ + arg_path + DQ + CN + SP + strerror(errno));
+        }
+
+        if (fstat(fd, &st) != 0)
+        {
+            string tmp_err = strerror(errno);
+
+            close(fd);
+            throw JsonSrcErr("cannot stat" + SP + DQ + arg_path + DQ + CN + SP + tmp_err);
+        }
+
+        if (!S_ISREG(st.st_mode))
+        {
+            close(fd);
+            throw JsonSrcErr("cannot map" + SP + DQ + arg_path + DQ + CN + SP + "not a regular file");
+        }
+
+        if (st.st_size == 0)
+        {
+            close(fd);
+            this->unmap();
+            this->txt.clear();
+            this->ptr = this->txt.data();
+            this->len = 0;
+            return;
+        }
+
+        tmp = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (tmp == MAP_FAILED)
+        {
+            string tmp_err = strerror(errno);
+
+            close(fd);
+            throw JsonSrcErr("cannot map" + SP + DQ + arg_path + DQ + CN + SP + tmp_err);
+        }
+
+        close(fd);
+        madvise(tmp, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+        this->unmap();
+        this->txt.clear();
+        this->map     = tmp;
+        this->map_len = static_cast<size_t>(st.st_size);
+        this->ptr     = static_cast<const char*>(tmp);
+        this->len     = this->map_len;
+    }
+
+    const char *
+    JsonSrc::get_ptr(void) const
+    {
+        return this->ptr;
+    }
+
+    size_t
+    JsonSrc::get_len(void) const
+    {
+        return this->len;
+    }
+}
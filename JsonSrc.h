@@ -0,0 +1,71 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _JSON_SRC_H_
+    #define _JSON_SRC_H_
+
+    #include <string>
+
+    namespace JsonParse
+    {
+        using std::string;
+        using std::size_t;
+
+        class JsonSrcErr
+        {
+            public:
+            string err_msg;
+
+            JsonSrcErr(string);
+            ~JsonSrcErr(void);
+
+            string get_msg(void);
+        };
+
+        /* JSON text to be parsed
+         *
+         * Holds either a copy of a string or a read-only mapping of a file.
+         * The text is not NUL terminated; tokens in json_tmod_view mode
+         * point into it, so it must outlive them.
+         */
+        class JsonSrc
+        {
+            private:
+            string       txt;
+            void       * map;
+            size_t       map_len;
+            const char * ptr;
+            size_t       len;
+
+            void unmap(void);
+
+            public:
+            JsonSrc(const string&);
+            JsonSrc(void);
+            JsonSrc(const JsonSrc&) = delete;
+            JsonSrc & operator=(const JsonSrc&) = delete;
+            ~JsonSrc(void);
+
+            void         set_file( const string& );
+            const char * get_ptr ( void          ) const;
+            size_t       get_len ( void          ) const;
+        };
+    }
+#endif
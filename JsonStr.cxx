@@ -18,10 +18,15 @@
  */
 
 /** \file  JsonStr.cxx
- *  \brief Defines the JsonStr class.
+ *  \brief Defines the JsonStr and JsonStrErr classes.
  */
 #include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
 #include <JsonVec.h>
+#include <JsonScan.h>
+#include <JsonNum.h>
 #include <JsonToken.h>
 #include <JsonStr.h>
 
@@ -30,10 +35,324 @@ namespace SyscJson
     using namespace std;
     using namespace SyscMsg;
     using namespace SyscMsg::Chars;
+    using namespace JsonParse;
+
+    // =============================================================================
+    // Class JsonStrErr
+    // =============================================================================
+    /** \brief Constructor for JsonStrErr exception class
+     *
+     *  Argument string may be used to describe the exception.
+     *
+     */
+    JsonStrErr::JsonStrErr(string s)
+    {
+        this->err_msg = s;
+    }
+
+    /** \brief Destructor for JsonStrErr exception class
+     *
+     *  No-op.
+     *
+     */
+    JsonStrErr::~JsonStrErr(void)
+    {
+    }
+
+    /** \brief Accessor method for JsonStrErr exception message
+     *
+     *  Returns the message string.
+     *
+     */
+    string
+    JsonStrErr::get_msg(void)
+    {
+        return "JsonStrErr reports" + SP + this->err_msg;
+    }
 
     // =============================================================================
     // Class JsonStr
     // =============================================================================
+    static const size_t str_buffer = 65536;
+
+    /* Output of a token serializer pass that only counts characters */
+    class SerCount
+    {
+        public:
+        size_t len;
+
+        SerCount(void) : len(0) {}
+
+        void put      ( char                  ) { this->len++;    }
+        void put      ( const char*, size_t n ) { this->len += n; }
+        void put_fill ( char, size_t n        ) { this->len += n; }
+    };
+
+    /* Output of a token serializer pass that writes into a buffer sized
+     * by a SerCount pass
+     */
+    class SerFill
+    {
+        public:
+        char * out;
+
+        SerFill(char * arg_out) : out(arg_out) {}
+
+        void put      ( char c                  ) { *(this->out++) = c;                        }
+        void put      ( const char* p, size_t n ) { memcpy(this->out, p, n); this->out += n; }
+        void put_fill ( char c, size_t n        ) { memset(this->out, c, n); this->out += n; }
+    };
+
+    /* Writes the argument characters between double quotes, escaped as
+     * in JsonStr::put_quoted()
+     */
+    template <typename W>
+    static void
+    ser_quoted(W & arg_out, const char * arg_ptr, size_t arg_len, bool arg_ascii)
+    {
+        arg_out.put('"');
+
+        while (arg_len > 0)
+        {
+            size_t len = json_esc_span(arg_ptr, arg_len, arg_ascii);
+
+            arg_out.put(arg_ptr, len);
+            arg_ptr += len;
+            arg_len -= len;
+
+            if (arg_len > 0)
+            {
+                char   esc[json_esc_max];
+                size_t esc_len;
+
+                len      = json_put_esc(esc, arg_ptr, arg_len, arg_ascii, esc_len);
+                arg_ptr += len;
+                arg_len -= len;
+
+                arg_out.put(esc, esc_len);
+            }
+        }
+
+        arg_out.put('"');
+    }
+
+    /* Writes the token argument as JSON text, with the comma argument set
+     * if a comma is due before the first item and left set if one is due
+     * after the last.  A nonzero indent argument writes each item of an
+     * object or array on its own line, indented by that many spaces per
+     * level of nesting within the tokens, and a space after each colon.
+     */
+    template <typename W>
+    static void
+    ser_tokens(W & arg_out, const Tokens & arg_val, bool & arg_comma, size_t arg_indent, bool arg_ascii)
+    {
+        size_t depth = 0;
+        bool   open  = false;
+        bool   after = false;
+
+        for (TokenCI dit = arg_val.begin() ; dit != arg_val.end() ; dit++)
+        {
+            if ((dit->struct_type == json_styp_obj_end) || (dit->struct_type == json_styp_arr_end))
+            {
+                if (depth > 0)
+                {
+                    depth--;
+
+                    if ((arg_indent > 0) && (!open))
+                    {
+                        arg_out.put('\n');
+                        arg_out.put_fill(' ', arg_indent * depth);
+                    }
+                }
+
+                arg_out.put((dit->struct_type == json_styp_obj_end) ? '}' : ']');
+                arg_comma = true;
+                open      = false;
+                after     = false;
+
+                continue;
+            }
+
+            if ((dit->struct_type != json_styp_obj_bgn) && (dit->struct_type != json_styp_arr_bgn) &&
+                (dit->struct_type != json_styp_key)     && (dit->struct_type != json_styp_elem))
+            {
+                continue;
+            }
+
+            if (arg_comma)
+            {
+                arg_out.put(',');
+            }
+
+            if ((arg_indent > 0) && (depth > 0) && (!after))
+            {
+                arg_out.put('\n');
+                arg_out.put_fill(' ', arg_indent * depth);
+            }
+
+            arg_comma = true;
+            open      = false;
+            after     = false;
+
+            switch (dit->struct_type)
+            {
+                case json_styp_obj_bgn :
+                {
+                    arg_out.put('{');
+                    arg_comma = false;
+                    open      = true;
+                    depth++;
+
+                    break;
+                }
+                case json_styp_arr_bgn :
+                {
+                    arg_out.put('[');
+                    arg_comma = false;
+                    open      = true;
+                    depth++;
+
+                    break;
+                }
+                case json_styp_key :
+                {
+                    ser_quoted(arg_out, dit->get_elem_ptr(), dit->get_elem_len(), arg_ascii);
+                    arg_out.put(':');
+
+                    if (arg_indent > 0)
+                    {
+                        arg_out.put(' ');
+                    }
+
+                    arg_comma = false;
+                    after     = true;
+
+                    break;
+                }
+                default :
+                {
+                    switch (dit->element_type)
+                    {
+                        case json_etyp_str : ser_quoted(arg_out, dit->get_elem_ptr(), dit->get_elem_len(), arg_ascii); break;
+                        case json_etyp_num : arg_out.put(dit->get_elem_ptr(), dit->get_elem_len());                    break;
+                        case json_etyp_nul : arg_out.put("null", 4);                                                   break;
+                        case json_etyp_tru : arg_out.put("true", 4);                                                   break;
+                        case json_etyp_fal : arg_out.put("false", 5);                                                  break;
+                        default            :                                                                           break;
+                    }
+
+                    break;
+                }
+            }
+        }
+    }
+
+    /** \brief Constructor for JsonStr writing to a file descriptor
+     *
+     *  The JSON text is written to the file descriptor argument with
+     *  write(), as the buffer fills and on flush().
+     */
+    JsonStr::JsonStr(int arg_fd)
+    {
+        this->str   = unique_ptr<string>(new string());
+        this->comma = false;
+        this->ascii = false;
+        this->sent  = 0;
+        this->limit = str_buffer;
+        this->sink  = [arg_fd](const char * arg_ptr, size_t arg_len)
+        {
+            while (arg_len > 0)
+            {
+                ssize_t len = write(arg_fd, arg_ptr, arg_len);
+
+                if ((len < 0) && (errno == EINTR))
+                {
+                    continue;
+                }
+
+                if (len < 0)
+                {
+                    throw JsonStrErr("failure in JsonStr::flush():" + SP + "write() failed:" + SP + strerror(errno));
+                }
+
+                if (len == 0)
+                {
+                    throw JsonStrErr("failure in JsonStr::flush():" + SP + "write() wrote nothing");
+                }
+
+                arg_ptr += len;
+                arg_len -= static_cast<size_t>(len);
+            }
+        };
+
+        this->str->reserve(this->limit);
+    }
+
+    /** \brief Constructor for JsonStr writing to a FILE
+     *
+     *  The JSON text is written to the FILE argument with fwrite(), as
+     *  the buffer fills and on flush(), which does not call fflush().
+     */
+    JsonStr::JsonStr(FILE * arg_file)
+    {
+        this->str   = unique_ptr<string>(new string());
+        this->comma = false;
+        this->ascii = false;
+        this->sent  = 0;
+        this->limit = str_buffer;
+        this->sink  = [arg_file](const char * arg_ptr, size_t arg_len)
+        {
+            if (fwrite(arg_ptr, 1, arg_len, arg_file) != arg_len)
+            {
+                throw JsonStrErr("failure in JsonStr::flush():" + SP + "fwrite() failed");
+            }
+        };
+
+        this->str->reserve(this->limit);
+    }
+
+    /** \brief Constructor for JsonStr writing to an ostream
+     *
+     *  The JSON text is written to the ostream argument, as the buffer
+     *  fills and on flush(), which does not flush the ostream.
+     */
+    JsonStr::JsonStr(ostream & arg_os)
+    {
+        ostream * os = &arg_os;
+
+        this->str   = unique_ptr<string>(new string());
+        this->comma = false;
+        this->ascii = false;
+        this->sent  = 0;
+        this->limit = str_buffer;
+        this->sink  = [os](const char * arg_ptr, size_t arg_len)
+        {
+            if (!os->write(arg_ptr, static_cast<streamsize>(arg_len)))
+            {
+                throw JsonStrErr("failure in JsonStr::flush():" + SP + "ostream write failed");
+            }
+        };
+
+        this->str->reserve(this->limit);
+    }
+
+    /** \brief Constructor for JsonStr writing to a callback
+     *
+     *  The callback argument is called with each piece of JSON text, as
+     *  the buffer fills and on flush().
+     */
+    JsonStr::JsonStr(JsonStrSink arg_sink)
+    {
+        this->str   = unique_ptr<string>(new string());
+        this->comma = false;
+        this->ascii = false;
+        this->sent  = 0;
+        this->limit = str_buffer;
+        this->sink  = arg_sink;
+
+        this->str->reserve(this->limit);
+    }
+
     /** \brief Constructor for JsonStr.
      *
      *  Instantiates a JsonStr instance.  JsonStr contains a
@@ -42,55 +361,145 @@ namespace SyscJson
      */
     JsonStr::JsonStr(void)
     {
-        this->str = unique_ptr<string>(new string());
+        this->str   = unique_ptr<string>(new string());
+        this->comma = false;
+        this->ascii = false;
+        this->sent  = 0;
+        this->limit = 0;
+
+        this->str->reserve(1024);
     }
 
     /** \brief Destructor for JsonStr.
      *
-     *  Deletes the string object.
+     *  Flushes the text buffered for an output sink, ignoring any
+     *  exception thrown in writing it, and deletes the string object.
+     */
+    JsonStr::~JsonStr(void)
+    {
+        try
+        {
+            this->flush();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    /** \brief Set the buffer size for an output sink
+     *
+     *  The buffered text is flushed to the sink once it reaches the size
+     *  argument, in bytes, which defaults to 64 KiB.  Has no effect
+     *  without a sink.
      */
-    JsonStr::~JsonStr(void) {}
+    void
+    JsonStr::set_buffer(size_t arg_len)
+    {
+        if (!this->sink)
+        {
+            return;
+        }
+
+        this->limit = (arg_len == 0) ? 1 : arg_len;
+        this->str->reserve(this->limit);
+    }
 
-    /* returns a boolean indicating that a comma
-     * needs to be appended to the current value
-     * of this->str.
-     * 
-     * Algorithm
-     * 1. return false if string is empty
-     * 2. find the last JSON character
-     * 3. return true or false based on the last JSON character
+    /** \brief Select ASCII output
+     *
+     *  With the argument true, characters above U+007F in keys and strings
+     *  are written as \\uXXXX escapes, and bytes that are not valid UTF-8
+     *  as \\ufffd.  Otherwise they are written as given, the default.
      */
-    bool
-    JsonStr::need_comma(void)
+    void
+    JsonStr::set_ascii(bool arg_ascii)
     {
-        string::const_iterator sit;
+        this->ascii = arg_ascii;
+    }
 
-        if (this->str->length() == 0)
+    /** \brief Write the buffered text to the output sink
+     *
+     *  The buffer is emptied.  Has no effect without a sink.  Throws
+     *  JsonStrErr if the sink cannot be written.
+     */
+    void
+    JsonStr::flush(void)
+    {
+        if ((!this->sink) || (this->str->empty()))
         {
-            return false;
+            return;
         }
 
-        for (sit = this->str->cend() ; sit != this->str->begin() ; sit--)
+        this->sink(this->str->data(), this->str->size());
+        this->sent += this->str->size();
+        this->str->clear();
+    }
+
+    /* Flushes the buffer to the output sink once it holds the buffer size */
+    void
+    JsonStr::put_limit(void)
+    {
+        if ((this->sink) && (this->str->size() >= this->limit))
         {
-            if ((isprint(*sit)) && (!(isspace(*sit))))
-            {
-                break;
-            }
+            this->flush();
         }
+    }
+
+    /* Appends a comma if the last thing appended was a value or the end
+     * of an object or array, and records that the next thing appended
+     * follows the argument, a value when true.  The string may have been
+     * emptied through get_str(), in which case no comma is needed, unless
+     * earlier text went to an output sink.
+     */
+    void
+    JsonStr::put_comma(bool arg_val)
+    {
+        this->put_limit();
 
-        switch (*sit)
+        if ((this->comma) && ((!this->str->empty()) || (this->sent > 0)))
         {
-            case ',' : return false;
-            case ':' : return false;
-            case '{' : return false;
-            case '[' : return false;
-            default  : return true;
+            this->str->push_back(',');
+        }
+
+        this->comma = arg_val;
+    }
+
+    /* Appends the argument characters between double quotes, escaped as
+     * a JSON string.  Runs that need no escaping are found many bytes at
+     * a time and appended whole.
+     */
+    void
+    JsonStr::put_quoted(const char * arg_ptr, size_t arg_len)
+    {
+        this->str->push_back('"');
+
+        while (arg_len > 0)
+        {
+            size_t len = json_esc_span(arg_ptr, arg_len, this->ascii);
+
+            this->str->append(arg_ptr, len);
+            arg_ptr += len;
+            arg_len -= len;
+
+            if (arg_len > 0)
+            {
+                char   esc[json_esc_max];
+                size_t esc_len;
+
+                len      = json_put_esc(esc, arg_ptr, arg_len, this->ascii, esc_len);
+                arg_ptr += len;
+                arg_len -= len;
+
+                this->str->append(esc, esc_len);
+            }
         }
+
+        this->str->push_back('"');
     }
 
     /** \brief Aquire access to string class attribute
      *
-     *  Returns a const reference to the string class attribute
+     *  Returns a const reference to the string class attribute.  With an
+     *  output sink, this holds only the text not yet flushed.
      */
     string &
     JsonStr::get_str(void) const
@@ -105,12 +514,8 @@ namespace SyscJson
     void
     JsonStr::add_obj_bgn(void)
     {
-        if (this->need_comma())
-        {
-            this->str->append(CM);
-        }
-
-        this->str->append("{");
+        this->put_comma(false);
+        this->str->push_back('{');
 
         return;
     }
@@ -122,7 +527,9 @@ namespace SyscJson
     void
     JsonStr::add_obj_end(void)
     {
-        this->str->append("}");
+        this->put_limit();
+        this->str->push_back('}');
+        this->comma = true;
 
         return;
     }
@@ -134,12 +541,8 @@ namespace SyscJson
     void
     JsonStr::add_arr_bgn(void)
     {
-        if (this->need_comma())
-        {
-            this->str->append(CM);
-        }
-
-        this->str->append("[");
+        this->put_comma(false);
+        this->str->push_back('[');
 
         return;
     }
@@ -151,7 +554,9 @@ namespace SyscJson
     void
     JsonStr::add_arr_end(void)
     {
-        this->str->append("]");
+        this->put_limit();
+        this->str->push_back(']');
+        this->comma = true;
 
         return;
     }
@@ -160,19 +565,16 @@ namespace SyscJson
      *
      *  Appends the string
      *
-     *          '"' + arg_key + '"' + ':'
+     *          '"' + escaped(arg_key) + '"' + ':'
      *
      *  (with a leading comma if required) to the string class attribute
      */
     void
     JsonStr::add_key(string & arg_key)
     {
-        if (this->need_comma())
-        {
-            this->str->append(CM);
-        }
-
-        this->str->append(DQ + arg_key + DQ + CN);
+        this->put_comma(false);
+        this->put_quoted(arg_key.data(), arg_key.size());
+        this->str->push_back(':');
 
         return;
     }
@@ -181,15 +583,17 @@ namespace SyscJson
      *
      *  Appends the string
      *
-     *          '"' + string(arg_key) + '"' + ':'
+     *          '"' + escaped(string(arg_key)) + '"' + ':'
      *
      *  (with a leading comma if required) to the string class attribute
      */
     void
     JsonStr::add_key(const char * arg_key)
     {
-        string tmp = string(arg_key);
-        this->add_key(tmp);
+        this->put_comma(false);
+        this->put_quoted(arg_key, strlen(arg_key));
+        this->str->push_back(':');
+
         return;
     }
 
@@ -197,19 +601,15 @@ namespace SyscJson
      *
      *  Appends the string
      *
-     *          '"' + arg_val + '"'
+     *          '"' + escaped(arg_val) + '"'
      *
      *  (with a leading comma if required) to the string class attribute
      */
     void
     JsonStr::add_str(string & arg_val)
     {
-        if (this->need_comma())
-        {
-            this->str->append(CM);
-        }
-
-        this->str->append(DQ + arg_val + DQ);
+        this->put_comma(true);
+        this->put_quoted(arg_val.data(), arg_val.size());
 
         return;
     }
@@ -218,15 +618,16 @@ namespace SyscJson
      *
      *  Appends the string
      *
-     *          '"' + string(arg_val) + '"'
+     *          '"' + escaped(string(arg_val)) + '"'
      *
      *  (with a leading comma if required) to the string class attribute
      */
     void
     JsonStr::add_str(const char * arg_val)
     {
-        string tmp = string(arg_val);
-        this->add_str(tmp);
+        this->put_comma(true);
+        this->put_quoted(arg_val, strlen(arg_val));
+
         return;
     }
 
@@ -241,11 +642,7 @@ namespace SyscJson
     void
     JsonStr::add_num(string & arg_val)
     {
-        if (this->need_comma())
-        {
-            this->str->append(CM);
-        }
-
+        this->put_comma(true);
         this->str->append(arg_val);
 
         return;
@@ -262,8 +659,60 @@ namespace SyscJson
     void
     JsonStr::add_num(const char * arg_val)
     {
-        string tmp = string(arg_val);
-        this->add_num(tmp);
+        this->put_comma(true);
+        this->str->append(arg_val);
+
+        return;
+    }
+
+    /** \brief Append a JSON number value from a signed integer
+     *
+     *  Appends the decimal digits of arg_val
+     *  (with a leading comma if required) to the string class attribute
+     */
+    void
+    JsonStr::add_num(int64_t arg_val)
+    {
+        char buf[json_fmt_max];
+
+        this->put_comma(true);
+        this->str->append(buf, json_fmt_int64(buf, arg_val));
+
+        return;
+    }
+
+    /** \brief Append a JSON number value from an unsigned integer
+     *
+     *  Appends the decimal digits of arg_val
+     *  (with a leading comma if required) to the string class attribute
+     */
+    void
+    JsonStr::add_num(uint64_t arg_val)
+    {
+        char buf[json_fmt_max];
+
+        this->put_comma(true);
+        this->str->append(buf, json_fmt_uint64(buf, arg_val));
+
+        return;
+    }
+
+    /** \brief Append a JSON number value from a double
+     *
+     *  Appends the shortest decimal text that reads back as arg_val,
+     *  without an exponent for magnitudes from 1e-6 up to 1e21, as in
+     *  JavaScript, (with a leading comma if required) to the string class
+     *  attribute.  NaN and infinity, which JSON cannot represent, are
+     *  appended as null.
+     */
+    void
+    JsonStr::add_num(double arg_val)
+    {
+        char buf[json_fmt_max];
+
+        this->put_comma(true);
+        this->str->append(buf, json_fmt_double(buf, arg_val));
+
         return;
     }
 
@@ -275,12 +724,8 @@ namespace SyscJson
     void
     JsonStr::add_nul(void)
     {
-        if (this->need_comma())
-        {
-            this->str->append(CM);
-        }
-
-        this->str->append("null");
+        this->put_comma(true);
+        this->str->append("null", 4);
 
         return;
     }
@@ -293,12 +738,8 @@ namespace SyscJson
     void
     JsonStr::add_tru(void)
     {
-        if (this->need_comma())
-        {
-            this->str->append(CM);
-        }
-
-        this->str->append("true");
+        this->put_comma(true);
+        this->str->append("true", 4);
 
         return;
     }
@@ -311,12 +752,8 @@ namespace SyscJson
     void
     JsonStr::add_fal(void)
     {
-        if (this->need_comma())
-        {
-            this->str->append(CM);
-        }
-
-        this->str->append("false");
+        this->put_comma(true);
+        this->str->append("false", 5);
 
         return;
     }
@@ -324,88 +761,61 @@ namespace SyscJson
     /** \brief Append a JSON snippet from a token vector
      *
      *  Appends a string based on the arg_val argument
-     *  (with a leading comma if required) to the string class attribute
+     *  (with a leading comma if required) to the string class attribute,
+     *  without whitespace.  Equivalent to add_val(arg_val, 0).
      */
     void
     JsonStr::add_val(Tokens & arg_val)
     {
-        for (TokenI dit = arg_val.begin() ; dit != arg_val.end() ; dit++)
-        {
-            switch (dit->struct_type)
-            {
-                case json_styp_obj_bgn :
-                {
-                    this->add_obj_bgn();
+        this->add_val(arg_val, 0);
 
-                    break;
-                }
-                case json_styp_obj_end :
-                {
-                    this->add_obj_end();
+        return;
+    }
 
-                    break;
-                }
-                case json_styp_arr_bgn :
-                {
-                    this->add_arr_bgn();
+    /** \brief Append a JSON snippet from a token vector, indented
+     *
+     *  Appends a string based on the arg_val argument
+     *  (with a leading comma if required) to the string class attribute.
+     *  With arg_indent nonzero, each item of an object or array is put on
+     *  its own line, indented by arg_indent spaces per level of nesting
+     *  within arg_val, and each key is followed by ": ", as by
+     *  JSON.stringify() in JavaScript.  Empty objects and arrays stay on
+     *  one line.  With arg_indent zero, no whitespace is added.
+     *
+     *  The length of the text is counted first, so the string grows at
+     *  most once, and the text is then written into it in place.  With an
+     *  output sink, the buffer may hold the whole of the text before it is
+     *  flushed.
+     */
+    void
+    JsonStr::add_val(Tokens & arg_val, size_t arg_indent)
+    {
+        SerCount cnt;
+        bool     comma = (this->comma) && ((!this->str->empty()) || (this->sent > 0));
+        bool     fill  = comma;
 
-                    break;
-                }
-                case json_styp_arr_end :
-                {
-                    this->add_arr_end();
+        this->put_limit();
 
-                    break;
-                }
-                case json_styp_key :
-                {
-                    this->add_key(dit->element_str);
+        ser_tokens(cnt, arg_val, comma, arg_indent, this->ascii);
 
-                    break;
-                }
-                case json_styp_elem :
-                {
-                    switch (dit->element_type)
-                    {
-                        case json_etyp_str :
-                        {
-                            this->add_str(dit->element_str);
-
-                            break;
-                        }
-                        case json_etyp_num :
-                        {
-                            this->add_num(dit->element_str);
-
-                            break;
-                        }
-                        case json_etyp_nul :
-                        {
-                            this->add_nul();
-
-                            break;
-                        }
-                        case json_etyp_tru :
-                        {
-                            this->add_tru();
-
-                            break;
-                        }
-                        case json_etyp_fal :
-                        {
-                            this->add_fal();
-
-                            break;
-                        }
-                        default : break;
-                    }
+        if (cnt.len > 0)
+        {
+            size_t base = this->str->size();
 
-                    break;
-                }
-                default : break;
-            }
+            this->str->resize(base + cnt.len);
+
+            SerFill out(&(*(this->str))[base]);
+
+            ser_tokens(out, arg_val, fill, arg_indent, this->ascii);
+        }
+
+        if (!arg_val.empty())
+        {
+            this->comma = comma;
         }
 
+        this->put_limit();
+
         return;
     }
 
@@ -419,16 +829,44 @@ namespace SyscJson
     void
     JsonStr::add_val(string & arg_val)
     {
-        this->add_num(arg_val);
+        size_t end = arg_val.size();
+
+        for ( ; (end > 0) && (isspace(static_cast<unsigned char>(arg_val[end - 1]))) ; end--)
+        {
+        }
+
+        if (end == 0)
+        {
+            this->put_limit();
+            this->str->append(arg_val);
+            return;
+        }
+
+        this->put_comma(true);
+        this->str->append(arg_val);
+
+        // a snippet may itself end where no comma should follow
+        switch (arg_val[end - 1])
+        {
+            case ',' : this->comma = false; break;
+            case ':' : this->comma = false; break;
+            case '{' : this->comma = false; break;
+            case '[' : this->comma = false; break;
+            default  : break;
+        }
     }
 
     /** \brief Remove all JSON values
      *
-     *  Resets the JsonStr to empty.
+     *  Resets the JsonStr to empty.  With an output sink, the text not yet
+     *  flushed is discarded, and the next text written starts a new JSON
+     *  string.
      */
     void
     JsonStr::rem_all(void)
     {
         this->str->clear();
+        this->comma = false;
+        this->sent  = 0;
     }
 }
@@ -18,12 +18,17 @@
  */
 
 /** \file  JsonStr.h
- *  \brief Declares the JsonStr class.
+ *  \brief Declares the JsonStr and JsonStrErr classes.
  */
 #ifndef _JSON_STR_H_
     #define _JSON_STR_H_
 
+    #include <cstdint>
+    #include <cstdio>
+    #include <functional>
+    #include <ostream>
     #include <string>
+    #include <type_traits>
     #include <SyscMsg.h>
     #include <JsonToken.h>
 
@@ -31,24 +36,108 @@
     {
         using std::string;
         using std::unique_ptr;
+        using std::size_t;
+        using std::function;
+        using std::ostream;
+        using std::FILE;
+        using std::int64_t;
+        using std::uint64_t;
+        using std::enable_if;
+        using std::is_integral;
+        using std::is_signed;
+
+        /** \brief Output sink for JsonStr, called with the start and length
+         *         of each piece of JSON text flushed
+         */
+        typedef function<void(const char*, size_t)> JsonStrSink;
+
+        /** \class JsonStrErr
+         *  \brief Exception class for JsonStr
+         *
+         *  This class is thrown by the JsonStr methods when the text cannot
+         *  be written to the output sink.
+         *
+         *  The err_msg string is set in the constructor and may be
+         *  used to indicate why the exception was thrown.  It is
+         *  accessed by the get_msg() method.
+         */
+        /** \var   JsonStrErr::err_msg
+         *  \brief String data for exception message
+         */
+        class JsonStrErr
+        {
+            public:
+            string err_msg;
+
+            JsonStrErr(string);
+            ~JsonStrErr(void);
+
+            string get_msg(void);
+        };
 
         /** \class JsonStr
          *  \brief Methods to operate on a JSON representation.
          *
          *  The JsonStr methods are used to operate on an internal representation
          *  of a JSON string.
+         *
+         *  Whether the next addition needs a leading comma is kept as state,
+         *  set by each add_*() method, so each addition appends its text to
+         *  the string directly, in time independent of the string length.
+         *
+         *  The add_key() and add_str() methods escape their argument as a
+         *  JSON string: quotes, backslashes and control characters, and
+         *  with set_ascii(), characters above U+007F.
+         *
+         *  The add_num() methods for integers and doubles format the number
+         *  directly into the string, a double as the shortest text that
+         *  reads back as the same double.  An integer of any type is
+         *  formatted as an int64_t or a uint64_t, by its signedness.
+         *
+         *  The add_val() methods for a token vector count the length of
+         *  the text before writing it, so the string grows at most once,
+         *  and may indent the text with one item per line.
+         *
+         *  <h2 class="mp">Output Sinks</h2>
+         *
+         *  A JsonStr constructed with a file descriptor, a FILE pointer, an
+         *  ostream or a JsonStrSink callback writes its text to that sink
+         *  instead of keeping it.  The string then serves as a buffer that
+         *  is flushed to the sink whenever it holds the buffer size set by
+         *  set_buffer(), so memory use is bounded however long the output.
+         *  The flush() method writes out what is buffered, as does the
+         *  destructor.  For such a JsonStr, get_str() returns only the text
+         *  not yet flushed.
+         *
+         *  The sink is not closed or owned by the JsonStr, and must outlive
+         *  it.
          */
         class JsonStr
         {
             private:
             unique_ptr<string> str;
+            bool               comma;
+            bool               ascii;
+            JsonStrSink        sink;
+            size_t             sent;
+            size_t             limit;
 
-            bool need_comma ( void );
+            void put_comma  ( bool                );
+            void put_quoted ( const char*, size_t );
+            void put_limit  ( void                );
 
             public:
+            JsonStr(int);
+            JsonStr(FILE*);
+            JsonStr(ostream&);
+            JsonStr(JsonStrSink);
             JsonStr(void);
             ~JsonStr(void);
 
+            void set_buffer  ( size_t           );
+            void set_ascii   ( bool             );
+            void flush       ( void             );
+
             void add_obj_bgn ( void             );
             void add_obj_end ( void             );
             void add_arr_bgn ( void             );
@@ -59,14 +148,41 @@
             void add_str     ( const char*      );
             void add_num     ( string&          );
             void add_num     ( const char*      );
+            void add_num     ( int64_t          );
+            void add_num     ( uint64_t         );
+            void add_num     ( double           );
             void add_nul     ( void             );
             void add_tru     ( void             );
             void add_fal     ( void             );
             void add_val     ( Tokens&          );
+            void add_val     ( Tokens&, size_t  );
             void add_val     ( string&          );
             void rem_all     ( void             );
 
             string & get_str(void) const;
+
+            template <typename T>
+            typename enable_if<is_integral<T>::value>::type add_num(T);
         };
+
+        /** \brief Append a JSON number value from any other integer type
+         *
+         *  Forwards arg_val to add_num(int64_t) or add_num(uint64_t), so
+         *  that int, long long and their unsigned forms are not ambiguous
+         *  on any platform, whichever of them int64_t is.
+         */
+        template <typename T>
+        typename enable_if<is_integral<T>::value>::type
+        JsonStr::add_num(T arg_val)
+        {
+            if (is_signed<T>::value)
+            {
+                this->add_num(static_cast<int64_t>(arg_val));
+            }
+            else
+            {
+                this->add_num(static_cast<uint64_t>(arg_val));
+            }
+        }
     }
 #endif
@@ -0,0 +1,884 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** \file  JsonTape.cxx
+ *  \brief Defines the JsonTape class.
+ */
+
+#include <cstring>
+#include "JsonSrc.h"
+#include "JsonStr.h"
+#include "JsonTape.h"
+
+namespace SyscJson
+{
+    using namespace std;
+    using namespace JsonParse;
+
+    /* Tape word layout
+     *
+     *   63..61  JsonStructTypes
+     *   60..58  JsonElementTypes
+     *   57      string data is in the source, not the arena
+     *   56..0   string data offset, or index of the matching begin or
+     *           end word
+     *
+     * Keys, strings and numbers are followed by a word holding the
+     * string data length.
+     *
+     * In the json_tmod_view token mode, posn holds the source offset of
+     * the first character of the token at each first word, or
+     * tape_no_posn for a value a projection put in place of one dropped,
+     * which has no source text.
+     */
+    static const int      tape_styp_shft = 61;
+    static const int      tape_etyp_shft = 58;
+    static const uint64_t tape_type_mask = 0x7;
+    static const uint64_t tape_src_bit   = uint64_t(1) << 57;
+    static const uint64_t tape_val_mask  = tape_src_bit - 1;
+    static const size_t   tape_no_posn   = static_cast<size_t>(-1);
+
+    // =============================================================================
+    // Class JsonTape
+    // =============================================================================
+    bool
+    JsonTape::KeyView::operator==(const KeyView & arg) const
+    {
+        return (this->len == arg.len) && ((this->len == 0) || (memcmp(this->ptr, arg.ptr, this->len) == 0));
+    }
+
+    /* FNV-1a */
+    size_t
+    JsonTape::KeyHash::operator()(const KeyView & arg) const
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+
+        for (size_t i = 0 ; i < arg.len ; i++)
+        {
+            hash ^= static_cast<unsigned char>(arg.ptr[i]);
+            hash *= 0x100000001b3ULL;
+        }
+
+        return static_cast<size_t>(hash);
+    }
+
+    /** \brief Constructor for an empty tape
+     *
+     */
+    JsonTape::JsonTape(void)
+    {
+        this->src_ptr = nullptr;
+        this->src_pos = 0;
+        this->base    = 0;
+        this->tmod    = json_tmod_copy;
+        this->key_min  = 0;
+        this->elem_min = 0;
+    }
+
+    /** \brief Copy the tokens and index settings of the argument tape
+     *
+     *  The indexes refer to the string data of the argument tape, so
+     *  none are copied; build_key_index() and build_elem_index() build
+     *  them for the copy.
+     */
+    JsonTape::JsonTape(const JsonTape & arg_tape)
+    {
+        this->tape     = arg_tape.tape;
+        this->open     = arg_tape.open;
+        this->base     = arg_tape.base;
+        this->arena    = arg_tape.arena;
+        this->src      = arg_tape.src;
+        this->src_ptr  = arg_tape.src_ptr;
+        this->src_pos  = arg_tape.src_pos;
+        this->posn     = arg_tape.posn;
+        this->tmod     = arg_tape.tmod;
+        this->key_min  = arg_tape.key_min;
+        this->elem_min = arg_tape.elem_min;
+    }
+
+    /** \brief No-op
+     *
+     */
+    JsonTape::~JsonTape(void) { }
+
+    /* The source is retained only when tokens refer to it */
+    void
+    JsonTape::set_source(shared_ptr<const JsonSrc> arg_src, JsonTokenModes arg_tmod)
+    {
+        this->src_ptr = arg_src->get_ptr();
+        this->tmod    = arg_tmod;
+
+        if (arg_tmod == json_tmod_view)
+        {
+            this->src = arg_src;
+        }
+        else
+        {
+            this->src.reset();
+        }
+    }
+
+    void
+    JsonTape::put_word(JsonStructTypes arg_styp, JsonElementTypes arg_etyp, bool arg_src, uint64_t arg_val)
+    {
+        uint64_t word;
+
+        word  = static_cast<uint64_t>(arg_styp) << tape_styp_shft;
+        word |= static_cast<uint64_t>(arg_etyp) << tape_etyp_shft;
+        word |= arg_src ? tape_src_bit : 0;
+        word |= arg_val & tape_val_mask;
+
+        this->tape.push_back(word);
+
+        if (this->src != nullptr)
+        {
+            this->posn.push_back(this->src_pos);
+        }
+    }
+
+    /* The second word of a key, string or number */
+    void
+    JsonTape::put_len(size_t arg_len)
+    {
+        this->tape.push_back(arg_len);
+
+        if (this->src != nullptr)
+        {
+            this->posn.push_back(0);
+        }
+    }
+
+    /* Source offset of the next token */
+    void
+    JsonTape::set_posn(size_t arg_pos)
+    {
+        this->src_pos = arg_pos;
+    }
+
+    /* Begin words are patched with the index of the matching end word
+     * when it arrives.  Indices are counted from the first word since
+     * construction, so a begin word removed by clear() is not patched.
+     */
+    void
+    JsonTape::put_struc(JsonStructTypes arg_styp)
+    {
+        size_t idx = this->base + this->tape.size();
+        size_t bgn;
+
+        if ((arg_styp == json_styp_obj_bgn) || (arg_styp == json_styp_arr_bgn))
+        {
+            this->open.push_back(idx);
+            this->put_word(arg_styp, json_etyp_LAST, false, 0);
+            return;
+        }
+
+        bgn = this->open.back();
+        this->open.pop_back();
+
+        if (bgn < this->base)
+        {
+            this->put_word(arg_styp, json_etyp_LAST, false, 0);
+            return;
+        }
+
+        this->tape[bgn - this->base] |= (idx - this->base) & tape_val_mask;
+        this->put_word(arg_styp, json_etyp_LAST, false, bgn - this->base);
+    }
+
+    void
+    JsonTape::put_elem(JsonElementTypes arg_etyp)
+    {
+        this->put_word(json_styp_elem, arg_etyp, false, 0);
+    }
+
+    /* Null, or an empty object or array, in place of a value dropped by
+     * a projection.  The words get no source offset, so get_view() does
+     * not take the dropped value's text for theirs.
+     */
+    void
+    JsonTape::put_empty(JsonStructTypes arg_styp)
+    {
+        size_t pos = this->src_pos;
+
+        this->src_pos = tape_no_posn;
+
+        switch (arg_styp)
+        {
+            case json_styp_obj_bgn :
+            {
+                this->put_struc(json_styp_obj_bgn);
+                this->put_struc(json_styp_obj_end);
+                break;
+            }
+            case json_styp_arr_bgn :
+            {
+                this->put_struc(json_styp_arr_bgn);
+                this->put_struc(json_styp_arr_end);
+                break;
+            }
+            default :
+            {
+                this->put_elem(json_etyp_nul);
+                break;
+            }
+        }
+
+        this->src_pos = pos;
+    }
+
+    void
+    JsonTape::put_str(JsonStructTypes arg_styp, JsonElementTypes arg_etyp, const char * arg_ptr, size_t arg_len)
+    {
+        this->put_word(arg_styp, arg_etyp, false, this->arena.size());
+        this->put_len(arg_len);
+        this->arena.append(arg_ptr, arg_len);
+    }
+
+    /* String data at an offset into the source */
+    void
+    JsonTape::put_src(JsonStructTypes arg_styp, JsonElementTypes arg_etyp, size_t arg_off, size_t arg_len)
+    {
+        if (this->tmod == json_tmod_view)
+        {
+            this->put_word(arg_styp, arg_etyp, true, arg_off);
+            this->put_len(arg_len);
+        }
+        else
+        {
+            this->put_str(arg_styp, arg_etyp, this->src_ptr + arg_off, arg_len);
+        }
+    }
+
+    void
+    JsonTape::clear(void)
+    {
+        this->base += this->tape.size();
+        this->tape.clear();
+        this->posn.clear();
+        this->arena.clear();
+        this->key_idx.clear();
+        this->elem_idx.clear();
+    }
+
+    /* Keep only the whole values from the first index argument up to the
+     * second, within an object begin and end when the last argument is
+     * set.  Begin and end words are rebased to the kept words.
+     */
+    void
+    JsonTape::keep(size_t arg_bgn, size_t arg_end, bool arg_wrap)
+    {
+        uint64_t         etyp = static_cast<uint64_t>(json_etyp_LAST) << tape_etyp_shft;
+        size_t           ofs  = arg_wrap ? 1 : 0;
+        size_t           len  = arg_end - arg_bgn + 2 * ofs;
+        vector<uint64_t> tmp;
+        vector<size_t>   pos;
+
+        tmp.reserve(len);
+
+        if (arg_wrap)
+        {
+            tmp.push_back((static_cast<uint64_t>(json_styp_obj_bgn) << tape_styp_shft) | etyp | (len - 1));
+        }
+
+        for (size_t i = arg_bgn ; i < arg_end ; i = this->next(i))
+        {
+            switch (this->get_styp(i))
+            {
+                case json_styp_obj_bgn :
+                case json_styp_obj_end :
+                case json_styp_arr_bgn :
+                case json_styp_arr_end :
+                {
+                    tmp.push_back((this->tape[i] & ~tape_val_mask) | (this->get_match(i) - arg_bgn + ofs));
+                    break;
+                }
+                default :
+                {
+                    tmp.insert(tmp.end(), this->tape.begin() + i, this->tape.begin() + this->next(i));
+                    break;
+                }
+            }
+        }
+
+        if (arg_wrap)
+        {
+            tmp.push_back((static_cast<uint64_t>(json_styp_obj_end) << tape_styp_shft) | etyp);
+        }
+
+        if (!this->posn.empty())
+        {
+            pos.assign(this->posn.begin() + arg_bgn, this->posn.begin() + arg_end);
+
+            if (arg_wrap)
+            {
+                pos.insert(pos.begin(), this->posn[arg_bgn]);
+                pos.push_back(this->posn[arg_end - 1]);
+            }
+        }
+
+        this->tape.swap(tmp);
+        this->posn.swap(pos);
+        this->open.clear();
+        this->key_idx.clear();
+        this->elem_idx.clear();
+    }
+
+    /** \brief Number of words in the tape
+     *
+     */
+    size_t
+    JsonTape::size(void) const
+    {
+        return this->tape.size();
+    }
+
+    /** \brief True when the tape holds no tokens
+     *
+     */
+    bool
+    JsonTape::empty(void) const
+    {
+        return this->tape.empty();
+    }
+
+    /** \brief Index of the token following the token at the argument index
+     *
+     */
+    size_t
+    JsonTape::next(size_t arg_idx) const
+    {
+        if (this->get_styp(arg_idx) == json_styp_key)
+        {
+            return arg_idx + 2;
+        }
+
+        switch (this->get_etyp(arg_idx))
+        {
+            case json_etyp_str : return arg_idx + 2;
+            case json_etyp_num : return arg_idx + 2;
+            default            : return arg_idx + 1;
+        }
+    }
+
+    /** \brief Index of the token following the value at the argument index
+     *
+     *  For an object or array begin, this is the token after the matching
+     *  end.  For a key, it is the token after the key's value.
+     */
+    size_t
+    JsonTape::skip(size_t arg_idx) const
+    {
+        switch (this->get_styp(arg_idx))
+        {
+            case json_styp_key     : return this->skip(arg_idx + 2);
+            case json_styp_obj_bgn : return this->get_match(arg_idx) + 1;
+            case json_styp_arr_bgn : return this->get_match(arg_idx) + 1;
+            default                : return this->next(arg_idx);
+        }
+    }
+
+    /** \brief Index of the end or begin word matching the object or array
+     *         begin or end at the argument index
+     */
+    size_t
+    JsonTape::get_match(size_t arg_idx) const
+    {
+        return static_cast<size_t>(this->tape[arg_idx] & tape_val_mask);
+    }
+
+    /** \brief Structural type of the token at the argument index
+     *
+     */
+    JsonStructTypes
+    JsonTape::get_styp(size_t arg_idx) const
+    {
+        return static_cast<JsonStructTypes>((this->tape[arg_idx] >> tape_styp_shft) & tape_type_mask);
+    }
+
+    /** \brief Element type of the token at the argument index
+     *
+     */
+    JsonElementTypes
+    JsonTape::get_etyp(size_t arg_idx) const
+    {
+        return static_cast<JsonElementTypes>((this->tape[arg_idx] >> tape_etyp_shft) & tape_type_mask);
+    }
+
+    /** \brief Start of the key, string or number data at the argument index
+     *
+     */
+    const char *
+    JsonTape::get_ptr(size_t arg_idx) const
+    {
+        uint64_t word = this->tape[arg_idx];
+
+        if (word & tape_src_bit)
+        {
+            return this->src_ptr + (word & tape_val_mask);
+        }
+
+        return this->arena.data() + (word & tape_val_mask);
+    }
+
+    /** \brief Length of the key, string or number data at the argument index
+     *
+     */
+    size_t
+    JsonTape::get_len(size_t arg_idx) const
+    {
+        return static_cast<size_t>(this->tape[arg_idx + 1]);
+    }
+
+    /** \brief True when the string data at the argument index equals the
+     *         argument string data
+     */
+    bool
+    JsonTape::cmp_str(size_t arg_idx, const char * arg_ptr, size_t arg_len) const
+    {
+        if (this->get_len(arg_idx) != arg_len)
+        {
+            return false;
+        }
+
+        return (arg_len == 0) || (memcmp(this->get_ptr(arg_idx), arg_ptr, arg_len) == 0);
+    }
+
+    /** \brief Loads the token argument from the argument index
+     *
+     *  As for the parser, string data held in the source is viewed and
+     *  other string data is copied.
+     */
+    void
+    JsonTape::get_token(size_t arg_idx, Token & arg_tok) const
+    {
+        JsonStructTypes  styp = this->get_styp(arg_idx);
+        JsonElementTypes etyp = this->get_etyp(arg_idx);
+
+        if ((styp != json_styp_key) && (etyp != json_etyp_str) && (etyp != json_etyp_num))
+        {
+            arg_tok = Token(styp, etyp);
+        }
+        else if (this->tape[arg_idx] & tape_src_bit)
+        {
+            arg_tok = Token(styp, etyp, this->get_ptr(arg_idx), this->get_len(arg_idx));
+        }
+        else
+        {
+            arg_tok = Token(styp, etyp, string(this->get_ptr(arg_idx), this->get_len(arg_idx)));
+        }
+    }
+
+    /** \brief Loads the ::Tokens argument with all tokens
+     *
+     *  Tokens viewing the source are valid while the tape exists.
+     */
+    void
+    JsonTape::get_tokens(Tokens & arg_tok) const
+    {
+        this->get_tokens(arg_tok, 0, this->tape.size());
+    }
+
+    /** \brief Loads the ::Tokens argument with the tokens from the first
+     *         index up to, but not including, the second index
+     */
+    void
+    JsonTape::get_tokens(Tokens & arg_tok, size_t arg_bgn, size_t arg_end) const
+    {
+        arg_tok.clear();
+
+        for (size_t idx = arg_bgn ; idx < arg_end ; idx = this->next(idx))
+        {
+            arg_tok.emplace_back();
+            this->get_token(idx, arg_tok.back());
+        }
+    }
+
+    /* Index the keys of the object at the argument index, keeping the
+     * first of duplicate keys as a linear search would
+     */
+    void
+    JsonTape::put_key_index(size_t arg_obj) const
+    {
+        KeyIndex & idx = this->key_idx[arg_obj];
+
+        for (size_t kit = this->next(arg_obj) ; this->get_styp(kit) == json_styp_key ; kit = this->skip(kit))
+        {
+            KeyView key = { this->get_ptr(kit), this->get_len(kit) };
+
+            idx.emplace(key, kit);
+        }
+    }
+
+    /** \brief Set the number of keys for which an object is indexed
+     *
+     *  Objects with at least the argument number of keys are indexed on
+     *  the first find_key() into them.  Zero, the default, disables
+     *  indexing.
+     */
+    void
+    JsonTape::set_key_index(size_t arg_min)
+    {
+        this->key_min = arg_min;
+    }
+
+    /** \brief Index all objects with at least the number of keys set by
+     *         set_key_index()
+     *
+     */
+    void
+    JsonTape::build_key_index(void)
+    {
+        for (size_t idx = 0 ; idx < this->tape.size() ; idx = this->next(idx))
+        {
+            if (this->get_styp(idx) == json_styp_obj_bgn)
+            {
+                this->has_key_index(idx);
+            }
+        }
+    }
+
+    /** \brief True when find_key() into the object at the argument index
+     *         uses an index
+     *
+     *  The index is built if the object has enough keys.
+     */
+    bool
+    JsonTape::has_key_index(size_t arg_obj) const
+    {
+        size_t cnt = 0;
+
+        if (this->key_idx.count(arg_obj) != 0)
+        {
+            return true;
+        }
+
+        // a key and its value take at least three words
+        if ((this->key_min == 0) || ((this->get_match(arg_obj) - arg_obj) < (3 * this->key_min)))
+        {
+            return false;
+        }
+
+        for (size_t kit = this->next(arg_obj) ; this->get_styp(kit) == json_styp_key ; kit = this->skip(kit))
+        {
+            if (++cnt == this->key_min)
+            {
+                this->put_key_index(arg_obj);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /** \brief Index of the first key in the object at the first argument
+     *         index equal to the argument string data
+     *
+     *  Returns the index of the object end if there is no such key.
+     */
+    size_t
+    JsonTape::find_key(size_t arg_obj, const char * arg_ptr, size_t arg_len) const
+    {
+        size_t kit;
+
+        if (this->has_key_index(arg_obj))
+        {
+            const KeyIndex & idx = this->key_idx.find(arg_obj)->second;
+            KeyView          key = { arg_ptr, arg_len };
+            auto             hit = idx.find(key);
+
+            return (hit == idx.end()) ? this->get_match(arg_obj) : hit->second;
+        }
+
+        for (kit = this->next(arg_obj) ; this->get_styp(kit) == json_styp_key ; kit = this->skip(kit))
+        {
+            if (this->cmp_str(kit, arg_ptr, arg_len))
+            {
+                break;
+            }
+        }
+
+        return kit;
+    }
+
+    /* Record the index of each item of the array at the argument index */
+    void
+    JsonTape::put_elem_index(size_t arg_arr) const
+    {
+        ElemIndex & idx = this->elem_idx[arg_arr];
+
+        for (size_t vit = this->next(arg_arr) ; this->get_styp(vit) != json_styp_arr_end ; vit = this->skip(vit))
+        {
+            idx.push_back(vit);
+        }
+    }
+
+    /** \brief Set the number of items for which an array is indexed
+     *
+     *  Arrays with at least the argument number of items are indexed on
+     *  the first find_elem() into them.  Zero, the default, disables
+     *  indexing.
+     */
+    void
+    JsonTape::set_elem_index(size_t arg_min)
+    {
+        this->elem_min = arg_min;
+    }
+
+    /** \brief Index all arrays with at least the number of items set by
+     *         set_elem_index()
+     *
+     */
+    void
+    JsonTape::build_elem_index(void)
+    {
+        for (size_t idx = 0 ; idx < this->tape.size() ; idx = this->next(idx))
+        {
+            if (this->get_styp(idx) == json_styp_arr_bgn)
+            {
+                this->has_elem_index(idx);
+            }
+        }
+    }
+
+    /** \brief True when find_elem() into the array at the argument index
+     *         uses an index
+     *
+     *  The index is built if the array has enough items.
+     */
+    bool
+    JsonTape::has_elem_index(size_t arg_arr) const
+    {
+        size_t cnt = 0;
+
+        if (this->elem_idx.count(arg_arr) != 0)
+        {
+            return true;
+        }
+
+        // an item takes at least one word
+        if ((this->elem_min == 0) || ((this->get_match(arg_arr) - arg_arr) <= this->elem_min))
+        {
+            return false;
+        }
+
+        for (size_t vit = this->next(arg_arr) ; this->get_styp(vit) != json_styp_arr_end ; vit = this->skip(vit))
+        {
+            if (++cnt == this->elem_min)
+            {
+                this->put_elem_index(arg_arr);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /** \brief Index of the item in the array at the first argument index
+     *         at the second argument position
+     *
+     *  When the third argument is true, the position counts back from
+     *  the end of the array, the last item being position 1.  Returns
+     *  the index of the array end if there is no such item.
+     */
+    size_t
+    JsonTape::find_elem(size_t arg_arr, size_t arg_pos, bool arg_from_end) const
+    {
+        size_t cnt = 0;
+        size_t vit;
+
+        if (this->has_elem_index(arg_arr))
+        {
+            const ElemIndex & idx = this->elem_idx.find(arg_arr)->second;
+
+            if (arg_from_end)
+            {
+                arg_pos = ((arg_pos == 0) || (arg_pos > idx.size())) ? idx.size() : (idx.size() - arg_pos);
+            }
+
+            return (arg_pos < idx.size()) ? idx[arg_pos] : this->get_match(arg_arr);
+        }
+
+        if (arg_from_end)
+        {
+            for (vit = this->next(arg_arr) ; this->get_styp(vit) != json_styp_arr_end ; vit = this->skip(vit))
+            {
+                cnt++;
+            }
+
+            if ((arg_pos == 0) || (arg_pos > cnt))
+            {
+                return vit;
+            }
+
+            arg_pos = cnt - arg_pos;
+        }
+
+        for (vit = this->next(arg_arr) ; this->get_styp(vit) != json_styp_arr_end ; vit = this->skip(vit))
+        {
+            if (arg_pos-- == 0)
+            {
+                break;
+            }
+        }
+
+        return vit;
+    }
+
+    /** \brief Source text of the token or value at the argument index
+     *
+     *  Returns true and sets the arguments to the text of the JSON source
+     *  for the token, or for the whole object or array at an object or
+     *  array begin.  For keys and strings the text is that between the
+     *  quotes, with any escape sequences as in the source.  Returns false
+     *  unless the tape was loaded in the json_tmod_view token mode, and
+     *  for a null, empty object or empty array that a projection put in
+     *  place of a value, which has no source text.
+     */
+    bool
+    JsonTape::get_view(size_t arg_idx, const char * & arg_ptr, size_t & arg_len) const
+    {
+        const char * str;
+        size_t       end;
+
+        if (this->src == nullptr)
+        {
+            return false;
+        }
+
+        if (this->tape[arg_idx] & tape_src_bit)
+        {
+            arg_ptr = this->get_ptr(arg_idx);
+            arg_len = this->get_len(arg_idx);
+            return true;
+        }
+
+        if (this->posn[arg_idx] == tape_no_posn)
+        {
+            return false;
+        }
+
+        arg_ptr = this->src_ptr + this->posn[arg_idx];
+
+        switch (this->get_styp(arg_idx))
+        {
+            case json_styp_obj_bgn : arg_len = this->posn[this->get_match(arg_idx)] + 1 - this->posn[arg_idx]; return true;
+            case json_styp_arr_bgn : arg_len = this->posn[this->get_match(arg_idx)] + 1 - this->posn[arg_idx]; return true;
+            case json_styp_obj_end : arg_len = 1; return true;
+            case json_styp_arr_end : arg_len = 1; return true;
+            default                : break;
+        }
+
+        switch (this->get_etyp(arg_idx))
+        {
+            case json_etyp_nul : arg_len = 4; return true;
+            case json_etyp_tru : arg_len = 4; return true;
+            case json_etyp_fal : arg_len = 5; return true;
+            default            : break;
+        }
+
+        // a string with escape sequences, the source has been validated
+        str = arg_ptr + 1;
+
+        for (end = 0 ; str[end] != '"' ; end++)
+        {
+            if (str[end] == '\\')
+            {
+                end++;
+            }
+        }
+
+        arg_ptr = str;
+        arg_len = end;
+        return true;
+    }
+
+    /** \brief String representation of the token or value at the
+     *         argument index
+     *
+     *  As JsonFind::get_context_string(): the JSON representation of an
+     *  object or array, the string value of a key, string or number, and
+     *  "null", "true" or "false" otherwise.
+     */
+    void
+    JsonTape::get_string(size_t arg_idx, string & arg_str) const
+    {
+        switch (this->get_styp(arg_idx))
+        {
+            case json_styp_key  : arg_str.assign(this->get_ptr(arg_idx), this->get_len(arg_idx)); return;
+            case json_styp_elem : break;
+            default             :
+            {
+                Tokens  tvec;
+                JsonStr jstr;
+
+                this->get_tokens(tvec, arg_idx, this->skip(arg_idx));
+                jstr.add_val(tvec);
+                arg_str = jstr.get_str();
+                return;
+            }
+        }
+
+        switch (this->get_etyp(arg_idx))
+        {
+            case json_etyp_nul : arg_str = "null";  break;
+            case json_etyp_tru : arg_str = "true";  break;
+            case json_etyp_fal : arg_str = "false"; break;
+            default            : arg_str.assign(this->get_ptr(arg_idx), this->get_len(arg_idx)); break;
+        }
+    }
+
+    /** \brief Index of the object or array holding the value at the first
+     *         argument index
+     *
+     *  The second argument is set to the index of the key of the object
+     *  or array if it is an object member, otherwise to zero.  Returns
+     *  size() for the top-level object or array.  The tape is descended
+     *  from the top level, stepping over the values preceding the
+     *  argument index at each level.
+     */
+    size_t
+    JsonTape::get_parent(size_t arg_idx, size_t & arg_kit) const
+    {
+        size_t par = this->tape.size();
+        size_t dit = 0;
+        size_t kit = 0;
+
+        arg_kit = 0;
+
+        while (dit != arg_idx)
+        {
+            par     = dit;
+            arg_kit = kit;
+            kit     = 0;
+
+            for (dit = this->next(dit) ; this->skip(dit) <= arg_idx ; dit = this->skip(dit))
+            {
+            }
+
+            if (this->get_styp(dit) == json_styp_key)
+            {
+                kit = dit;
+                dit = this->next(dit);
+            }
+        }
+
+        return par;
+    }
+}
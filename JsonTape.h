@@ -0,0 +1,165 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** \file  JsonTape.h
+ *  \brief Declares the JsonTape class.
+ */
+
+#ifndef _JSON_TAPE_H_
+    #define _JSON_TAPE_H_
+
+    #include <cstdint>
+    #include <memory>
+    #include <string>
+    #include <unordered_map>
+    #include <vector>
+    #include <JsonToken.h>
+
+    namespace JsonParse
+    {
+        class JsonSrc;
+        class JsonVec;
+    }
+
+    namespace SyscJson
+    {
+        using std::shared_ptr;
+        using std::string;
+        using std::unordered_map;
+        using std::vector;
+        using std::size_t;
+        using std::uint64_t;
+
+        /** \class JsonTape
+         *  \brief Compact representation of parsed JSON
+         *
+         *  The parser loads a JsonTape with one 64 bit word for each
+         *  object or array begin or end, null, true or false, and two
+         *  words for each key, string or number.  The first word holds
+         *  the structural and element types and the offset of the string
+         *  data, the second word its length.  String data is held in a
+         *  single arena, or in the parsed source for the json_tmod_view
+         *  token mode.
+         *
+         *  Object and array begin and end words hold the index of the
+         *  matching end or begin word, so the skip() and get_match()
+         *  methods take constant time.
+         *
+         *  Objects may be given a hash index from key to key token, built
+         *  on the first find_key() into an object with at least the
+         *  number of keys set by set_key_index(), or for all such
+         *  objects by build_key_index().  Arrays may likewise be given a
+         *  table of item tokens by set_elem_index() or build_elem_index(),
+         *  so find_elem() takes constant time.  Building an index modifies
+         *  the tape, so a tape must not be searched from several threads
+         *  while indexes may be built.  A copy of a tape has the index
+         *  settings of the original but none of its indexes.
+         *
+         *  In the json_tmod_view token mode the tape also records the
+         *  source offset of each token, and get_view() gives the source
+         *  text of any token, object or array without copying it.
+         *
+         *  A token is identified by the index of its first word.  The
+         *  next() method steps from token to token, and skip() steps over
+         *  a whole value.  The get_tokens() methods provide the
+         *  equivalent ::Tokens.
+         */
+        class JsonTape
+        {
+            friend class JsonParse::JsonVec;
+
+            private:
+            struct KeyView
+            {
+                const char * ptr;
+                size_t       len;
+
+                bool operator==(const KeyView&) const;
+            };
+
+            struct KeyHash
+            {
+                size_t operator()(const KeyView&) const;
+            };
+
+            typedef unordered_map<KeyView, size_t, KeyHash> KeyIndex;
+            typedef vector<size_t>                          ElemIndex;
+
+            vector<uint64_t>                          tape;
+            vector<size_t>                            open;
+            size_t                                    base;
+            string                                    arena;
+            shared_ptr<const JsonParse::JsonSrc>      src;
+            const char                              * src_ptr;
+            size_t                                    src_pos;
+            vector<size_t>                            posn;
+            JsonTokenModes                            tmod;
+            size_t                                    key_min;
+            mutable unordered_map<size_t, KeyIndex>   key_idx;
+            size_t                                    elem_min;
+            mutable unordered_map<size_t, ElemIndex>  elem_idx;
+
+            void set_source     ( shared_ptr<const JsonParse::JsonSrc>, JsonTokenModes );
+            void put_word       ( JsonStructTypes, JsonElementTypes, bool, uint64_t    );
+            void put_struc      ( JsonStructTypes                                       );
+            void put_len        ( size_t                                                );
+            void set_posn       ( size_t                                                );
+            void put_elem       ( JsonElementTypes                                      );
+            void put_empty      ( JsonStructTypes                                       );
+            void put_str        ( JsonStructTypes, JsonElementTypes, const char*, size_t );
+            void put_src        ( JsonStructTypes, JsonElementTypes, size_t, size_t     );
+            void clear          ( void                                                  );
+            void keep           ( size_t, size_t, bool                                  );
+            void put_key_index  ( size_t                                                ) const;
+            void put_elem_index ( size_t                                                ) const;
+
+            public:
+            JsonTape(void);
+            JsonTape(const JsonTape&);
+            JsonTape & operator=(const JsonTape&) = delete;
+            ~JsonTape(void);
+
+            size_t           size             ( void                          ) const;
+            bool             empty            ( void                          ) const;
+            size_t           next             ( size_t                        ) const;
+            size_t           skip             ( size_t                        ) const;
+            size_t           get_match        ( size_t                        ) const;
+            JsonStructTypes  get_styp         ( size_t                        ) const;
+            JsonElementTypes get_etyp         ( size_t                        ) const;
+            const char     * get_ptr          ( size_t                        ) const;
+            size_t           get_len          ( size_t                        ) const;
+            bool             cmp_str          ( size_t, const char*, size_t   ) const;
+            void             get_token        ( size_t, Token&                ) const;
+            void             get_tokens       ( Tokens&                       ) const;
+            void             get_tokens       ( Tokens&, size_t, size_t       ) const;
+            void             set_key_index    ( size_t                        );
+            void             build_key_index  ( void                          );
+            bool             has_key_index    ( size_t                        ) const;
+            size_t           find_key         ( size_t, const char*, size_t   ) const;
+            void             set_elem_index   ( size_t                        );
+            void             build_elem_index ( void                          );
+            bool             has_elem_index   ( size_t                        ) const;
+            size_t           find_elem        ( size_t, size_t, bool          ) const;
+            bool             get_view         ( size_t, const char*&, size_t& ) const;
+            void             get_string       ( size_t, string&               ) const;
+            size_t           get_parent       ( size_t, size_t&               ) const;
+        };
+    }
+#endif
@@ -20,6 +20,7 @@
 /** \file  JsonToken.cxx
  *  \brief Defines the JsonToken class.
  */
+#include <cstring>
 #include "SyscMsg.h"
 #include "JsonToken.h"
 
@@ -44,6 +45,20 @@ namespace SyscJson
         struct_type  = arg_styp;
         element_type = arg_vtyp;
         element_str  = arg_cstr;
+        element_ptr  = nullptr;
+        element_len  = 0;
+    }
+
+    /** \brief Constructor for JSON tokens viewing key, number or string data
+     *
+     *  The token refers to arg_len bytes at arg_ptr, which must outlive it.
+     */
+    JsonToken::JsonToken(JsonStructTypes arg_styp, JsonElementTypes arg_vtyp, const char * arg_ptr, size_t arg_len)
+    {
+        struct_type  = arg_styp;
+        element_type = arg_vtyp;
+        element_ptr  = arg_ptr;
+        element_len  = arg_len;
     }
 
     /** \brief Constructor for JSON tokens describing true, false or null
@@ -54,6 +69,8 @@ namespace SyscJson
         struct_type  = arg_styp;
         element_type = arg_vtyp;
         element_str  = "";
+        element_ptr  = nullptr;
+        element_len  = 0;
     }
 
     /** \brief Constructor for JSON tokens describing begin or end of array or object
@@ -64,6 +81,8 @@ namespace SyscJson
         struct_type  = arg_styp;
         element_type = json_etyp_LAST;
         element_str  = "";
+        element_ptr  = nullptr;
+        element_len  = 0;
     }
 
     /** \brief Constructor for an empty token
@@ -74,6 +93,8 @@ namespace SyscJson
         struct_type  = json_styp_LAST;
         element_type = json_etyp_LAST;
         element_str  = "";
+        element_ptr  = nullptr;
+        element_len  = 0;
     }
 
     /** \brief No-op
@@ -133,6 +154,66 @@ namespace SyscJson
         }
     }
 
+    /** \brief True when token string data is held in the parsed source
+     *
+     */
+    bool
+    JsonToken::has_elem_view(void) const
+    {
+        if (this->element_ptr != nullptr)
+        {
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /** \brief Start of the token string data, in either token mode
+     *
+     */
+    const char *
+    JsonToken::get_elem_ptr(void) const
+    {
+        if (this->has_elem_view())
+        {
+            return this->element_ptr;
+        }
+
+        return this->element_str.data();
+    }
+
+    /** \brief Length of the token string data, in either token mode
+     *
+     */
+    size_t
+    JsonToken::get_elem_len(void) const
+    {
+        if (this->has_elem_view())
+        {
+            return this->element_len;
+        }
+
+        return this->element_str.length();
+    }
+
+    /** \brief True when the token string data equals that of the argument
+     *
+     */
+    bool
+    JsonToken::cmp_elem_str(const JsonToken & arg) const
+    {
+        size_t len = this->get_elem_len();
+
+        if (len != arg.get_elem_len())
+        {
+            return false;
+        }
+
+        return (len == 0) || (memcmp(this->get_elem_ptr(), arg.get_elem_ptr(), len) == 0);
+    }
+
     /** \brief Appends decoded token information to the argument string
      *
      */
@@ -163,13 +244,15 @@ namespace SyscJson
         // string
         if (this->has_elem_str())
         {
+            string elem(this->get_elem_ptr(), this->get_elem_len());
+
             if (this->element_type == json_etyp_str)
             {
-                str.append(TB + DQ + this->element_str + DQ);
+                str.append(TB + DQ + elem + DQ);
             }
             else
             {
-                str.append(TB + this->element_str);
+                str.append(TB + elem);
             }
         }
 
@@ -207,8 +290,7 @@ namespace SyscJson
             return false;
         }
 
-        str.clear();
-        str.insert(0, this->element_str);
+        str.assign(this->get_elem_ptr(), this->get_elem_len());
         return true;
     }
 }
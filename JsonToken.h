@@ -31,6 +31,8 @@
     #define _JSON_TOK_H_
 
     #include <array>
+    #include <cstddef>
+    #include <string>
     #include <vector>
 
     /** \brief Public namespace for the SyscJson library, libsyscjson
@@ -39,7 +41,8 @@
      *  and JsonParser.  The JsonParser namespace is intended to be
      *  visible only inside the SyscJson library, and not visible to
      *  users of the library.  This separation may be enforced by 
-     *  installing only JsonToken.h, JsonFind.h and JsonStr.h into
+     *  installing only JsonToken.h, JsonTape.h, JsonPath.h, JsonCursor.h,
+     *  JsonDoc.h, JsonFind.h, JsonPush.h and JsonStr.h into
      *  /usr/include/syscjson
      */
     namespace SyscJson
@@ -47,6 +50,7 @@
         using std::string;
         using std::array;
         using std::vector;
+        using std::size_t;
 
         /** \brief JSON token structural types
          *
@@ -108,6 +112,40 @@
             }
         };
 
+        /** \brief JSON parser engines
+         *
+         *  The parser engines are enumerated as JsonEngines, which select
+         *  + the flex/bison parser
+         *  + the structural-index parser, using SSE4.2 or AVX2 kernels
+         *    when the CPU supports them and scalar kernels otherwise
+         *  + the structural-index parser, using scalar kernels only
+         *
+         *  All engines produce the same ::Tokens for the same input.
+         */
+        enum JsonEngines
+        {
+            json_engn_flex,       /**< flex/bison parser                */
+            json_engn_simd,       /**< structural-index parser          */
+            json_engn_scal,       /**< structural-index parser, scalar  */
+            json_engn_LAST        /**< end of enumeration               */
+        };
+
+        /** \brief JSON token string modes
+         *
+         *  The token string modes are enumerated as JsonTokenModes, which
+         *  indicate whether the parser
+         *  + copies key, string and number data into JsonToken::element_str
+         *  + leaves key, string and number data in the parsed source, and
+         *    points JsonToken::element_ptr at it.  Only strings containing
+         *    escape sequences are copied.
+         */
+        enum JsonTokenModes
+        {
+            json_tmod_copy,       /**< copy into element_str            */
+            json_tmod_view,       /**< view of the source where possible */
+            json_tmod_LAST        /**< end of enumeration               */
+        };
+
         /** \class JsonToken
          *  \brief Container for Token
          *
@@ -133,14 +171,28 @@
          *  \brief String data for JSON string and number types
          *
          */
+        /** \var   JsonToken::element_ptr
+         *  \brief String data held in the parsed source, or nullptr
+         *
+         *  Set instead of #element_str by the json_tmod_view token mode.
+         *  Use get_elem_ptr() and get_elem_len() to read string data in
+         *  either mode.
+         */
+        /** \var   JsonToken::element_len
+         *  \brief Length of the string data at #element_ptr
+         *
+         */
         class JsonToken
         {
             public:
             JsonStructTypes  struct_type;
             JsonElementTypes element_type;
             string           element_str;
+            const char     * element_ptr;
+            size_t           element_len;
 
             JsonToken(JsonStructTypes, JsonElementTypes, const string&);
+            JsonToken(JsonStructTypes, JsonElementTypes, const char*, size_t);
             JsonToken(JsonStructTypes, JsonElementTypes);
             JsonToken(JsonStructTypes);
             JsonToken(void);
@@ -149,8 +201,13 @@
             bool has_struc     ( void    ) const;
             bool has_elem      ( void    ) const;
             bool has_elem_str  ( void    ) const;
+            bool has_elem_view ( void    ) const;
             void dump_token    ( string& );
             bool get_token_str ( string& );
+
+            const char * get_elem_ptr ( void             ) const;
+            size_t       get_elem_len ( void             ) const;
+            bool         cmp_elem_str ( const JsonToken& ) const;
         };
 
         /** \typedef Tokens
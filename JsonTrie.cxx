@@ -0,0 +1,261 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "JsonTrie.h"
+
+namespace JsonParse
+{
+    using namespace std;
+    using namespace SyscJson;
+
+    // =============================================================================
+    // Class JsonTrie
+    // =============================================================================
+    /* Node for the argument step, or the root node for nullptr */
+    JsonTrie::JsonTrie(const JsonPathStep * arg_step)
+    {
+        this->step = arg_step;
+    }
+
+    JsonTrie::~JsonTrie(void) { }
+
+    bool
+    JsonTrie::same_step(const JsonPathStep & arg) const
+    {
+        if (this->step->op       != arg.op)       return false;
+        if (this->step->styp     != arg.styp)     return false;
+        if (this->step->sel_key  != arg.sel_key)  return false;
+        if (this->step->from_end != arg.from_end) return false;
+        if (this->step->idx      != arg.idx)      return false;
+        if (this->step->key      != arg.key)      return false;
+        return true;
+    }
+
+    /* Add the steps of the path from the argument step number on, marking
+     * the last step's node with the path number
+     */
+    void
+    JsonTrie::add(const JsonPath & arg_path, size_t arg_step, size_t arg_num)
+    {
+        if (arg_step == arg_path.size())
+        {
+            this->ends.push_back(arg_num);
+            return;
+        }
+
+        const JsonPathStep & tmp = arg_path.get_step(arg_step);
+
+        for (auto & kid : this->kids)
+        {
+            if (kid->same_step(tmp))
+            {
+                kid->add(arg_path, arg_step + 1, arg_num);
+                return;
+            }
+        }
+
+        this->kids.emplace_back(new JsonTrie(&tmp));
+        this->kids.back()->add(arg_path, arg_step + 1, arg_num);
+    }
+
+    /* Resolve all paths from the root node, setting the result for each
+     * path number to the selected value and its key, or leaving it
+     * unchanged
+     */
+    void
+    JsonTrie::find(const JsonTape & arg_tape, vector<JsonTrieHit> & arg_rslt) const
+    {
+        if (arg_tape.empty())
+        {
+            return;
+        }
+
+        for (auto & kid : this->kids)
+        {
+            kid->find_at(arg_tape, 0, 0, arg_rslt);
+        }
+    }
+
+    /* This node's step has reached the value at the first index, with key
+     * at the second index for a key step
+     */
+    void
+    JsonTrie::find_at(const JsonTape & arg_tape, size_t arg_dit, size_t arg_kit, vector<JsonTrieHit> & arg_rslt) const
+    {
+        if (this->step->op == json_path_none)
+        {
+            return;
+        }
+
+        if ((this->step->styp != json_styp_LAST) && (arg_tape.get_styp(arg_dit) != this->step->styp))
+        {
+            return;
+        }
+
+        for (size_t num : this->ends)
+        {
+            arg_rslt[num].dit = arg_dit;
+            arg_rslt[num].kit = arg_kit;
+        }
+
+        if (this->kids.empty())
+        {
+            return;
+        }
+
+        switch (arg_tape.get_styp(arg_dit))
+        {
+            case json_styp_obj_bgn : this->find_obj(arg_tape, arg_dit, arg_rslt); break;
+            case json_styp_arr_bgn : this->find_arr(arg_tape, arg_dit, arg_rslt); break;
+            default                : break;
+        }
+    }
+
+    /* One scan of the object's keys for all key and member steps, taking
+     * the first of duplicate keys, or a lookup for each step in an indexed
+     * object
+     */
+    void
+    JsonTrie::find_obj(const JsonTape & arg_tape, size_t arg_dit, vector<JsonTrieHit> & arg_rslt) const
+    {
+        vector<bool> done(this->kids.size(), false);
+        size_t       todo = 0;
+
+        for (size_t i = 0 ; i < this->kids.size() ; i++)
+        {
+            if ((this->kids[i]->step->op == json_path_key) || (this->kids[i]->step->op == json_path_member))
+            {
+                todo++;
+            }
+            else
+            {
+                done[i] = true;
+            }
+        }
+
+        if (arg_tape.has_key_index(arg_dit))
+        {
+            for (size_t i = 0 ; i < this->kids.size() ; i++)
+            {
+                const string & key = this->kids[i]->step->key;
+                size_t         kit;
+
+                if (done[i])
+                {
+                    continue;
+                }
+
+                kit = arg_tape.find_key(arg_dit, key.data(), key.size());
+
+                if (arg_tape.get_styp(kit) == json_styp_key)
+                {
+                    this->kids[i]->find_at(arg_tape, arg_tape.next(kit), kit, arg_rslt);
+                }
+            }
+
+            return;
+        }
+
+        for (size_t kit = arg_tape.next(arg_dit) ; (todo > 0) && (arg_tape.get_styp(kit) == json_styp_key) ; kit = arg_tape.skip(kit))
+        {
+            for (size_t i = 0 ; i < this->kids.size() ; i++)
+            {
+                const string & key = this->kids[i]->step->key;
+
+                if ((done[i]) || (!arg_tape.cmp_str(kit, key.data(), key.size())))
+                {
+                    continue;
+                }
+
+                done[i] = true;
+                todo--;
+
+                this->kids[i]->find_at(arg_tape, arg_tape.next(kit), kit, arg_rslt);
+            }
+        }
+    }
+
+    /* One scan of the array's items for all index, member and first item
+     * steps, or a lookup for index and member steps from the end or into an
+     * indexed array
+     */
+    void
+    JsonTrie::find_arr(const JsonTape & arg_tape, size_t arg_dit, vector<JsonTrieHit> & arg_rslt) const
+    {
+        vector<bool> done(this->kids.size(), false);
+        size_t       todo = 0;
+        size_t       sidx = 0;
+
+        for (size_t i = 0 ; i < this->kids.size() ; i++)
+        {
+            const JsonPathStep & tmp = *(this->kids[i]->step);
+
+            bool                 idx = (tmp.op == json_path_idx) || (tmp.op == json_path_member);
+
+            if ((idx) && (tmp.from_end || arg_tape.has_elem_index(arg_dit)))
+            {
+                size_t vit = arg_tape.find_elem(arg_dit, tmp.idx, tmp.from_end);
+
+                done[i] = true;
+
+                if (arg_tape.get_styp(vit) != json_styp_arr_end)
+                {
+                    this->kids[i]->find_at(arg_tape, vit, 0, arg_rslt);
+                }
+            }
+            else if ((idx) || (tmp.op == json_path_first))
+            {
+                todo++;
+            }
+            else
+            {
+                done[i] = true;
+            }
+        }
+
+        for (size_t vit = arg_tape.next(arg_dit) ; (todo > 0) && (arg_tape.get_styp(vit) != json_styp_arr_end) ; vit = arg_tape.skip(vit), sidx++)
+        {
+            for (size_t i = 0 ; i < this->kids.size() ; i++)
+            {
+                const JsonPathStep & tmp = *(this->kids[i]->step);
+
+                if (done[i])
+                {
+                    continue;
+                }
+
+                if (((tmp.op == json_path_idx) || (tmp.op == json_path_member)) && (tmp.idx == sidx))
+                {
+                    done[i] = true;
+                    todo--;
+
+                    this->kids[i]->find_at(arg_tape, vit, 0, arg_rslt);
+                }
+                else if ((tmp.op == json_path_first) && (tmp.styp == arg_tape.get_styp(vit)))
+                {
+                    done[i] = true;
+                    todo--;
+
+                    this->kids[i]->find_at(arg_tape, vit, 0, arg_rslt);
+                }
+            }
+        }
+    }
+}
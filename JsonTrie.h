@@ -0,0 +1,75 @@
+/*
+ * Copyright 2013 Robert Newgard
+ *
+ * This file is part of SyscJson.
+ *
+ * SyscJson is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SyscJson is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _JSON_TRIE_H_
+    #define _JSON_TRIE_H_
+
+    #include <memory>
+    #include <vector>
+
+    #include "JsonTape.h"
+    #include "JsonPath.h"
+
+    namespace JsonParse
+    {
+        using std::unique_ptr;
+        using std::vector;
+        using std::size_t;
+        using SyscJson::JsonTape;
+        using SyscJson::JsonPath;
+        using SyscJson::JsonPathStep;
+
+        /* Value selected by a path, with its key index or zero */
+        struct JsonTrieHit
+        {
+            size_t dit;
+            size_t kit;
+        };
+
+        /* Prefix trie of search path steps
+         *
+         * Paths sharing leading steps share trie nodes, so that find()
+         * resolves every path in a single descent through the tape,
+         * scanning each object or array on the way once for all of the
+         * steps below it.
+         */
+        class JsonTrie
+        {
+            friend class JsonProj;
+
+            private:
+            const JsonPathStep           * step;
+            vector<size_t>                 ends;
+            vector<unique_ptr<JsonTrie>>   kids;
+
+            bool same_step ( const JsonPathStep& ) const;
+            void find_obj  ( const JsonTape&, size_t, vector<JsonTrieHit>& ) const;
+            void find_arr  ( const JsonTape&, size_t, vector<JsonTrieHit>& ) const;
+            void find_at   ( const JsonTape&, size_t, size_t, vector<JsonTrieHit>& ) const;
+
+            public:
+            JsonTrie(const JsonPathStep*);
+            ~JsonTrie(void);
+
+            void add  ( const JsonPath&, size_t, size_t      );
+            void find ( const JsonTape&, vector<JsonTrieHit>& ) const;
+        };
+    }
+#endif
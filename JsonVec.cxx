@@ -18,6 +18,8 @@
  */
 
 #include "JsonVec.h"
+#include "JsonScan.h"
+#include "JsonProj.h"
 
 namespace JsonParse
 {
@@ -47,21 +49,18 @@ namespace JsonParse
     // =============================================================================
     // Class JsonVec
     // =============================================================================
-    JsonVec::JsonVec(const string & arg_src, const string & arg_msgid)
+    JsonVec::JsonVec(shared_ptr<const JsonSrc> arg_src, const string & arg_msgid, JsonEngines arg_engn, JsonTokenModes arg_tmod)
     {
-        this->msg = unique_ptr<Msg>(new Msg(arg_msgid.c_str()));
-        this->vec = unique_ptr<Tokens>(new Tokens);
-        this->str = arg_src;
+        this->msg  = unique_ptr<Msg>(new Msg(arg_msgid.c_str()));
+        this->tape = unique_ptr<JsonTape>(new JsonTape);
+        this->src  = arg_src;
+        this->proj = unique_ptr<JsonProj>(nullptr);
+
+        this->tape->set_source(arg_src, arg_tmod);
 
         try
         {
-            int ret = json_parse(reinterpret_cast<void*>(this), const_cast<char*>(this->str.c_str()));
-
-            if (ret)
-            {
-                this->msg->cerr_err("json_parse() returns" + SP + to_string(ret));
-                throw JsonVecErr("json_parse() returns" + SP + to_string(ret));
-            }
+            this->parse(arg_engn);
         }
         catch (JsonVecErr & err)
         {
@@ -71,20 +70,59 @@ namespace JsonParse
         }
     }
 
-    JsonVec::JsonVec(const string & arg_src)
+    JsonVec::JsonVec(shared_ptr<const JsonSrc> arg_src, JsonEngines arg_engn, JsonTokenModes arg_tmod)
     {
-        this->msg = unique_ptr<Msg>(nullptr);
-        this->vec = unique_ptr<Tokens>(new Tokens);
-        this->str = arg_src;
+        this->msg  = unique_ptr<Msg>(nullptr);
+        this->tape = unique_ptr<JsonTape>(new JsonTape);
+        this->src  = arg_src;
+        this->proj = unique_ptr<JsonProj>(nullptr);
+
+        this->tape->set_source(arg_src, arg_tmod);
 
         try
         {
-            int ret = json_parse(reinterpret_cast<void*>(this), const_cast<char*>(this->str.c_str()));
+            this->parse(arg_engn);
+        }
+        catch (JsonVecErr & err)
+        {
+            throw JsonVecErr("failure in JsonVec constructor:" + SP + err.get_msg());
+        }
+    }
 
-            if (ret)
-            {
-                throw JsonVecErr("json_parse() returns" + SP + to_string(ret));
-            }
+    /* Parse keeping only the tokens of the projection onto the paths */
+    JsonVec::JsonVec(shared_ptr<const JsonSrc> arg_src, const string & arg_msgid, JsonEngines arg_engn, JsonTokenModes arg_tmod, const vector<JsonPath> & arg_paths)
+    {
+        this->msg  = unique_ptr<Msg>(new Msg(arg_msgid.c_str()));
+        this->tape = unique_ptr<JsonTape>(new JsonTape);
+        this->src  = arg_src;
+        this->proj = unique_ptr<JsonProj>(new JsonProj(arg_paths));
+
+        this->tape->set_source(arg_src, arg_tmod);
+
+        try
+        {
+            this->parse(arg_engn);
+        }
+        catch (JsonVecErr & err)
+        {
+            this->msg->cerr_err("catch() in constructor");
+            this->msg->cerr_err(err.get_msg());
+            throw JsonVecErr("failure in JsonVec constructor:" + SP + err.get_msg());
+        }
+    }
+
+    JsonVec::JsonVec(shared_ptr<const JsonSrc> arg_src, JsonEngines arg_engn, JsonTokenModes arg_tmod, const vector<JsonPath> & arg_paths)
+    {
+        this->msg  = unique_ptr<Msg>(nullptr);
+        this->tape = unique_ptr<JsonTape>(new JsonTape);
+        this->src  = arg_src;
+        this->proj = unique_ptr<JsonProj>(new JsonProj(arg_paths));
+
+        this->tape->set_source(arg_src, arg_tmod);
+
+        try
+        {
+            this->parse(arg_engn);
         }
         catch (JsonVecErr & err)
         {
@@ -92,12 +130,62 @@ namespace JsonParse
         }
     }
 
+    JsonVec::JsonVec(const string & arg_src, const string & arg_msgid, JsonEngines arg_engn, JsonTokenModes arg_tmod) : JsonVec(make_shared<const JsonSrc>(arg_src), arg_msgid, arg_engn, arg_tmod) { }
+
+    JsonVec::JsonVec(const string & arg_src, JsonEngines arg_engn, JsonTokenModes arg_tmod) : JsonVec(make_shared<const JsonSrc>(arg_src), arg_engn, arg_tmod) { }
+
+    JsonVec::JsonVec(const string & arg_src, const string & arg_msgid) : JsonVec(arg_src, arg_msgid, json_engn_flex, json_tmod_copy) { }
+
+    JsonVec::JsonVec(const string & arg_src) : JsonVec(arg_src, json_engn_flex, json_tmod_copy) { }
+
+    /* Empty instance, loaded through the set_*() methods by the caller */
+    JsonVec::JsonVec(void)
+    {
+        this->msg  = unique_ptr<Msg>(nullptr);
+        this->tape = unique_ptr<JsonTape>(new JsonTape);
+        this->src  = make_shared<JsonSrc>();
+        this->proj = unique_ptr<JsonProj>(nullptr);
+
+        this->tape->set_source(this->src, json_tmod_copy);
+    }
+
     JsonVec::~JsonVec(void) { }
 
+    void
+    JsonVec::parse(JsonEngines arg_engn)
+    {
+        int ret;
+
+        if (arg_engn == json_engn_flex)
+        {
+            ret = json_parse(reinterpret_cast<void*>(this), this->src->get_ptr(), this->src->get_len());
+        }
+        else
+        {
+            JsonScan scan(*this, this->src->get_ptr(), this->src->get_len(), arg_engn);
+
+            ret = scan.scan();
+        }
+
+        if (ret)
+        {
+            if (this->msg)
+            {
+                this->msg->cerr_err("json_parse() returns" + SP + to_string(ret));
+            }
+
+            throw JsonVecErr("json_parse() returns" + SP + to_string(ret));
+        }
+    }
+
     void
     JsonVec::dump_vec(void)
     {
-        for (TokenI it = this->vec->begin() ; it != this->vec->end() ; it++)
+        Tokens tvec;
+
+        this->tape->get_tokens(tvec);
+
+        for (TokenI it = tvec.begin() ; it != tvec.end() ; it++)
         {
             switch (it->struct_type)
             {
@@ -123,7 +211,7 @@ namespace JsonParse
                 }
                 case json_styp_key :
                 {
-                    cout << DQ << it->element_str << DQ << CN;
+                    cout << DQ << string(it->get_elem_ptr(), it->get_elem_len()) << DQ << CN;
                     break;
                 }
                 case json_styp_elem :
@@ -132,12 +220,12 @@ namespace JsonParse
                     {
                         case json_etyp_str :
                         {
-                            cout << DQ << it->element_str << DQ;
+                            cout << DQ << string(it->get_elem_ptr(), it->get_elem_len()) << DQ;
                             break;
                         }
                         case json_etyp_num :
                         {
-                            cout << it->element_str;
+                            cout << string(it->get_elem_ptr(), it->get_elem_len());
                             break;
                         }
                         case json_etyp_nul :
@@ -166,13 +254,78 @@ namespace JsonParse
         cout << NL;
     }
 
+    /* Passes a value to the projection, if any, emptying a value not kept
+     * if required.  Returns true if the value is kept.
+     */
+    bool
+    JsonVec::put_proj(JsonStructTypes arg_styp)
+    {
+        JsonProjActs act;
+
+        if (!this->proj)
+        {
+            return true;
+        }
+
+        act = this->proj->put_val(arg_styp, false);
+
+        if (act == proj_empty)
+        {
+            this->put_empty(arg_styp);
+        }
+
+        return act == proj_keep;
+    }
+
+    /* Null, or an empty object or array, in place of a value */
+    void
+    JsonVec::put_empty(JsonStructTypes arg_styp)
+    {
+        this->tape->put_empty(arg_styp);
+    }
+
+    /* For a parser able to step over a value without decoding it, true
+     * when the value beginning, of the argument structural type, is not
+     * kept by the projection.  An empty value is put in its place if
+     * required, and the parser steps over the value without passing its
+     * tokens.
+     */
+    bool
+    JsonVec::skip_val(JsonStructTypes arg_styp)
+    {
+        JsonProjActs act;
+
+        if (!this->proj)
+        {
+            return false;
+        }
+
+        act = this->proj->put_val(arg_styp, true);
+
+        if (act == proj_empty)
+        {
+            this->put_empty(arg_styp);
+        }
+
+        return act != proj_keep;
+    }
+
+    /* Source offset of the next token, recorded in json_tmod_view mode */
+    void
+    JsonVec::set_posn(size_t arg_pos)
+    {
+        this->tape->set_posn(arg_pos);
+    }
+
     void
     JsonVec::set_obj_bgn(void)
     {
-        
-        JsonToken tmp(json_styp_obj_bgn);
+        if (!this->put_proj(json_styp_obj_bgn))
+        {
+            return;
+        }
 
-        this->vec->push_back(tmp);
+        this->tape->put_struc(json_styp_obj_bgn);
 
         if (this->msg)
         {
@@ -183,9 +336,12 @@ namespace JsonParse
     void
     JsonVec::set_obj_end(void)
     {
-        JsonToken tmp(json_styp_obj_end);
+        if ((this->proj) && (!this->proj->put_end()))
+        {
+            return;
+        }
 
-        this->vec->push_back(tmp);
+        this->tape->put_struc(json_styp_obj_end);
 
         if (this->msg)
         {
@@ -196,9 +352,12 @@ namespace JsonParse
     void
     JsonVec::set_arr_bgn(void)
     {
-        JsonToken tmp(json_styp_arr_bgn);
+        if (!this->put_proj(json_styp_arr_bgn))
+        {
+            return;
+        }
 
-        this->vec->push_back(tmp);
+        this->tape->put_struc(json_styp_arr_bgn);
 
         if (this->msg)
         {
@@ -209,9 +368,12 @@ namespace JsonParse
     void
     JsonVec::set_arr_end(void)
     {
-        JsonToken tmp(json_styp_arr_end);
+        if ((this->proj) && (!this->proj->put_end()))
+        {
+            return;
+        }
 
-        this->vec->push_back(tmp);
+        this->tape->put_struc(json_styp_arr_end);
 
         if (this->msg)
         {
@@ -220,24 +382,46 @@ namespace JsonParse
     }
 
     void
-    JsonVec::set_obj_key(char * arg_str)
+    JsonVec::set_obj_key(const char * arg_ptr, size_t arg_len)
+    {
+        if ((this->proj) && (!this->proj->put_key(arg_ptr, arg_len)))
+        {
+            return;
+        }
+
+        this->tape->put_str(json_styp_key, json_etyp_str, arg_ptr, arg_len);
+
+        if (this->msg)
+        {
+            this->msg->cerr_inf(DQ + string(arg_ptr, arg_len) + DQ + CN);
+        }
+    }
+
+    void
+    JsonVec::set_obj_key_src(size_t arg_off, size_t arg_len)
     {
-        JsonToken tmp(json_styp_key, json_etyp_str, string(arg_str));
+        if ((this->proj) && (!this->proj->put_key(this->src->get_ptr() + arg_off, arg_len)))
+        {
+            return;
+        }
 
-        this->vec->push_back(tmp);
+        this->tape->put_src(json_styp_key, json_etyp_str, arg_off, arg_len);
 
         if (this->msg)
         {
-            this->msg->cerr_inf((DQ + tmp.element_str + DQ + CN).c_str());
+            this->msg->cerr_inf(DQ + string(this->src->get_ptr() + arg_off, arg_len) + DQ + CN);
         }
     }
 
     void
     JsonVec::set_elem_nul(void)
     {
-        JsonToken tmp(json_styp_elem, json_etyp_nul);
+        if (!this->put_proj(json_styp_elem))
+        {
+            return;
+        }
 
-        this->vec->push_back(tmp);
+        this->tape->put_elem(json_etyp_nul);
 
         if (this->msg)
         {
@@ -248,9 +432,12 @@ namespace JsonParse
     void
     JsonVec::set_elem_tru(void)
     {
-        JsonToken tmp(json_styp_elem, json_etyp_tru);
+        if (!this->put_proj(json_styp_elem))
+        {
+            return;
+        }
 
-        this->vec->push_back(tmp);
+        this->tape->put_elem(json_etyp_tru);
 
         if (this->msg)
         {
@@ -261,9 +448,12 @@ namespace JsonParse
     void
     JsonVec::set_elem_fal(void)
     {
-        JsonToken tmp(json_styp_elem, json_etyp_fal);
+        if (!this->put_proj(json_styp_elem))
+        {
+            return;
+        }
 
-        this->vec->push_back(tmp);
+        this->tape->put_elem(json_etyp_fal);
 
         if (this->msg)
         {
@@ -272,50 +462,133 @@ namespace JsonParse
     }
 
     void
-    JsonVec::set_elem_str(char * arg_str)
+    JsonVec::set_elem_str(const char * arg_ptr, size_t arg_len)
     {
-        JsonToken tmp(json_styp_elem, json_etyp_str, string(arg_str));
+        if (!this->put_proj(json_styp_elem))
+        {
+            return;
+        }
 
-        this->vec->push_back(tmp);
+        this->tape->put_str(json_styp_elem, json_etyp_str, arg_ptr, arg_len);
 
         if (this->msg)
         {
-            this->msg->cerr_inf((DQ + tmp.element_str + DQ).c_str());
+            this->msg->cerr_inf(DQ + string(arg_ptr, arg_len) + DQ);
         }
     }
+
     void
-    JsonVec::set_elem_num(char * arg_str)
+    JsonVec::set_elem_str_src(size_t arg_off, size_t arg_len)
     {
-        JsonToken tmp(json_styp_elem, json_etyp_num, string(arg_str));
+        if (!this->put_proj(json_styp_elem))
+        {
+            return;
+        }
 
-        this->vec->push_back(tmp);
+        this->tape->put_src(json_styp_elem, json_etyp_str, arg_off, arg_len);
 
         if (this->msg)
         {
-            this->msg->cerr_inf(tmp.element_str.c_str());
+            this->msg->cerr_inf(DQ + string(this->src->get_ptr() + arg_off, arg_len) + DQ);
         }
     }
 
-    Tokens &
-    JsonVec::get_tokens(void)
+    void
+    JsonVec::set_elem_num(const char * arg_ptr, size_t arg_len)
     {
-        return *(this->vec);
+        if (!this->put_proj(json_styp_elem))
+        {
+            return;
+        }
+
+        this->tape->put_str(json_styp_elem, json_etyp_num, arg_ptr, arg_len);
+
+        if (this->msg)
+        {
+            this->msg->cerr_inf(string(arg_ptr, arg_len));
+        }
+    }
+
+    void
+    JsonVec::set_elem_num_src(size_t arg_off, size_t arg_len)
+    {
+        if (!this->put_proj(json_styp_elem))
+        {
+            return;
+        }
+
+        this->tape->put_src(json_styp_elem, json_etyp_num, arg_off, arg_len);
+
+        if (this->msg)
+        {
+            this->msg->cerr_inf(string(this->src->get_ptr() + arg_off, arg_len));
+        }
+    }
+
+    /* Discard the tokens so far, as they are taken by the caller */
+    void
+    JsonVec::clr_tape(void)
+    {
+        this->tape->clear();
+    }
+
+    /* Keep only the tokens of one value, for a caller searching the tape */
+    void
+    JsonVec::keep_tape(size_t arg_bgn, size_t arg_end, bool arg_wrap)
+    {
+        this->tape->keep(arg_bgn, arg_end, arg_wrap);
+    }
+
+    /* Exchange the tape with the caller's, for a caller taking the result */
+    void
+    JsonVec::swap_tape(unique_ptr<JsonTape> & arg_tape)
+    {
+        this->tape.swap(arg_tape);
+    }
+
+    /* Tokens in json_tmod_view mode refer to the source retained by the tape */
+    JsonTape &
+    JsonVec::get_tape(void)
+    {
+        return *(this->tape);
     }
 
     // =============================================================================
     // "C" Bindings for creating JsonVec instances
     // =============================================================================
+
+    // pos is the source offset of the first character of the next token
+    static JsonVec *
+    c_vec(void * cjv, size_t pos)
+    {
+        JsonVec * vec = reinterpret_cast<JsonVec*>(cjv);
+
+        vec->set_posn(pos);
+        return vec;
+    }
+
     extern "C"
     {
-        void c_set_obj_bgn(void * cjv)              { (reinterpret_cast<JsonVec*>(cjv))->set_obj_bgn();                }
-        void c_set_obj_end(void * cjv)              { (reinterpret_cast<JsonVec*>(cjv))->set_obj_end();                }
-        void c_set_arr_bgn(void * cjv)              { (reinterpret_cast<JsonVec*>(cjv))->set_arr_bgn();                }
-        void c_set_arr_end(void * cjv)              { (reinterpret_cast<JsonVec*>(cjv))->set_arr_end();                }
-        void c_set_obj_key(void * cjv, char * str)  { (reinterpret_cast<JsonVec*>(cjv))->set_obj_key(str); free(str);  }
-        void c_set_elem_nul(void * cjv)             { (reinterpret_cast<JsonVec*>(cjv))->set_elem_nul();               }
-        void c_set_elem_tru(void * cjv)             { (reinterpret_cast<JsonVec*>(cjv))->set_elem_tru();               }
-        void c_set_elem_fal(void * cjv)             { (reinterpret_cast<JsonVec*>(cjv))->set_elem_fal();               }
-        void c_set_elem_str(void * cjv, char * str) { (reinterpret_cast<JsonVec*>(cjv))->set_elem_str(str); free(str); }
-        void c_set_elem_num(void * cjv, char * str) { (reinterpret_cast<JsonVec*>(cjv))->set_elem_num(str);            }
+        void c_set_obj_bgn(void * cjv, size_t pos)              { c_vec(cjv, pos)->set_obj_bgn();               }
+        void c_set_obj_end(void * cjv, size_t pos)              { c_vec(cjv, pos)->set_obj_end();               }
+        void c_set_arr_bgn(void * cjv, size_t pos)              { c_vec(cjv, pos)->set_arr_bgn();               }
+        void c_set_arr_end(void * cjv, size_t pos)              { c_vec(cjv, pos)->set_arr_end();               }
+        void c_set_elem_nul(void * cjv, size_t pos)             { c_vec(cjv, pos)->set_elem_nul();              }
+        void c_set_elem_tru(void * cjv, size_t pos)             { c_vec(cjv, pos)->set_elem_tru();              }
+        void c_set_elem_fal(void * cjv, size_t pos)             { c_vec(cjv, pos)->set_elem_fal();              }
+        void c_set_elem_num(void * cjv, size_t off, size_t len) { c_vec(cjv, off)->set_elem_num_src(off, len); }
+
+        // own is a malloc()ed string holding decoded escapes, otherwise the string is in the source at off
+        void c_set_obj_key(void * cjv, char * own, size_t off, size_t len, size_t pos)
+        {
+            if (own == nullptr) { c_vec(cjv, pos)->set_obj_key_src(off, len);       }
+            else                { c_vec(cjv, pos)->set_obj_key(own, len); free(own); }
+        }
+
+        void c_set_elem_str(void * cjv, char * own, size_t off, size_t len, size_t pos)
+        {
+            if (own == nullptr) { c_vec(cjv, pos)->set_elem_str_src(off, len);       }
+            else                { c_vec(cjv, pos)->set_elem_str(own, len); free(own); }
+        }
     }
 }
@@ -29,13 +29,25 @@
 
     #include "SyscMsg.h"
     #include "JsonToken.h"
+    #include "JsonSrc.h"
+    #include "JsonTape.h"
+    #include "JsonPath.h"
 
     namespace JsonParse
     {
         using std::string;
         using std::unique_ptr;
+        using std::shared_ptr;
         using SyscMsg::Msg;
         using SyscJson::Tokens;
+        using SyscJson::JsonTape;
+        using SyscJson::JsonEngines;
+        using SyscJson::JsonTokenModes;
+        using SyscJson::JsonStructTypes;
+        using SyscJson::JsonPath;
+        using std::vector;
+
+        class JsonProj;
 
         class JsonVecErr
         {
@@ -51,28 +63,48 @@
         class JsonVec
         {
             private:
-            unique_ptr<Msg>    msg;
-            unique_ptr<Tokens> vec;
-            string             str;
+            unique_ptr<Msg>           msg;
+            unique_ptr<JsonTape>      tape;
+            shared_ptr<const JsonSrc> src;
+            unique_ptr<JsonProj>      proj;
+
+            void parse(JsonEngines);
+            bool put_proj(JsonStructTypes);
+            void put_empty(JsonStructTypes);
 
             public:
+            JsonVec(shared_ptr<const JsonSrc>, const string&, JsonEngines, JsonTokenModes);
+            JsonVec(shared_ptr<const JsonSrc>, JsonEngines, JsonTokenModes);
+            JsonVec(shared_ptr<const JsonSrc>, const string&, JsonEngines, JsonTokenModes, const vector<JsonPath>&);
+            JsonVec(shared_ptr<const JsonSrc>, JsonEngines, JsonTokenModes, const vector<JsonPath>&);
+            JsonVec(const string&, const string&, JsonEngines, JsonTokenModes);
+            JsonVec(const string&, JsonEngines, JsonTokenModes);
             JsonVec(const string&, const string&);
             JsonVec(const string&);
+            JsonVec(void);
             ~JsonVec(void);
 
             void dump_vec(void);
+            bool skip_val(JsonStructTypes);
+            void set_posn(size_t);
             void set_obj_bgn(void);
             void set_obj_end(void);
             void set_arr_bgn(void);
             void set_arr_end(void);
-            void set_obj_key(char*);
+            void set_obj_key(const char*, size_t);
+            void set_obj_key_src(size_t, size_t);
             void set_elem_nul(void);
             void set_elem_tru(void);
             void set_elem_fal(void);
-            void set_elem_str(char*);
-            void set_elem_num(char*);
+            void set_elem_str(const char*, size_t);
+            void set_elem_str_src(size_t, size_t);
+            void set_elem_num(const char*, size_t);
+            void set_elem_num_src(size_t, size_t);
 
-            Tokens    & get_tokens(void);
+            void       clr_tape(void);
+            void       keep_tape(size_t, size_t, bool);
+            void       swap_tape(unique_ptr<JsonTape>&);
+            JsonTape & get_tape(void);
         };
 
         extern "C"
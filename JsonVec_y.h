@@ -17,14 +17,14 @@
  * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-int  json_parse(void*, char*);
-void c_set_obj_bgn(void*);
-void c_set_obj_end(void*);
-void c_set_arr_bgn(void*);
-void c_set_arr_end(void*);
-void c_set_obj_key(void*, char*);
-void c_set_elem_nul(void*);
-void c_set_elem_tru(void*);
-void c_set_elem_fal(void*);
-void c_set_elem_str(void*, char*);
-void c_set_elem_num(void*, char*);
+int  json_parse(void*, const char*, size_t);
+void c_set_obj_bgn(void*, size_t);
+void c_set_obj_end(void*, size_t);
+void c_set_arr_bgn(void*, size_t);
+void c_set_arr_end(void*, size_t);
+void c_set_obj_key(void*, char*, size_t, size_t, size_t);
+void c_set_elem_nul(void*, size_t);
+void c_set_elem_tru(void*, size_t);
+void c_set_elem_fal(void*, size_t);
+void c_set_elem_str(void*, char*, size_t, size_t, size_t);
+void c_set_elem_num(void*, size_t, size_t);
@@ -18,11 +18,13 @@
  */
 
 /** \file  SyscJson.h
- *  \brief Brings in the JsonFind and JsonStr includes.
+ *  \brief Brings in the JsonDoc, JsonFind, JsonPush and JsonStr includes.
  */
 
 #ifndef _SYSCJSON_H_
     #define _SYSCJSON_H_
     #include <JsonStr.h>
+    #include <JsonDoc.h>
     #include <JsonFind.h>
+    #include <JsonPush.h>
 #endif
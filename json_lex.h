@@ -17,8 +17,6 @@
  * along with SyscJson.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <langinfo.h>
-#include <locale.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
@@ -26,64 +24,45 @@
 
 #define JL_DBG 0
 
-int    lex_start = 1;
-int    lex_ascii = 1;
-int    lex_idx   = 0;
-char * str_accum;
-char * lex_buffer;
-
-void
-locale_codeset ()
+/* Per-parse lexer state.  One instance lives on the stack of json_parse()
+ * and is reached from the scanner through yyextra and from the parser
+ * through its parse parameter, so concurrent parses share nothing.
+ */
+struct json_lex_state
 {
-    char * codeset;
-
-    setlocale(LC_CTYPE,"");
-    codeset = nl_langinfo(CODESET);
- 
-    if (strcmp(codeset, "UTF-8") == 0)
-    {
-        lex_ascii = 0;
-    }
-    else if (strcmp(codeset, "utf8") == 0)
-    {
-        lex_ascii = 0;
-    }
-
-    if (JL_DBG)
-    {
-        if (lex_ascii == 0)
-        {
-            fprintf(stderr, "codeset is \"%s\"; using UTF-8 character processing\n", codeset);
-        }
-        else
-        {
-            fprintf(stderr, "codeset is \"%s\"; using lex_ascii character processing\n", codeset);
-        }
-    }
-}
+    void       * cjv;
+    int          lex_start;
+    size_t       lex_idx;
+    size_t       str_bgn;
+    int          str_esc;
+    char       * str_accum;
+    size_t       str_len;
+    const char * lex_buffer;
+    size_t       lex_buffer_len;
+};
 
 void
-lexer_init ()
+lexer_init (struct json_lex_state * jls)
 {
     if (JL_DBG)
     {
         fprintf (stderr, "lexer_init()\n");
     }
 
-    lex_start = 0;
+    jls->lex_start = 0;
 }
 
 int
-concat_str (char ** str, const char * cat)
+concat_mem (struct json_lex_state * jls, const char * cat, size_t cat_len)
 {
+    char      ** str = &jls->str_accum;
     char       * newp;
     char       * wp;
     size_t       str_len;
-    size_t       cat_len = strlen (cat);
 
     if (JL_DBG)
     {
-        fprintf (stderr, "++ in concat_str(), cat is \"%s\", cat_len is %zd\n", cat, cat_len);
+        fprintf (stderr, "++ in concat_str(), cat is \"%.*s\", cat_len is %zd\n", (int) cat_len, cat, cat_len);
     }
 
     if (*str == NULL)
@@ -110,7 +89,7 @@ concat_str (char ** str, const char * cat)
         {
             fprintf (stderr, "++ in concat_str(), *str is \"%s\"\n", *str);
         }
-        str_len = strlen (*str);
+        str_len = jls->str_len;
         newp    = (char *) realloc (*str, str_len + cat_len + 1);
 
         if (newp == NULL)
@@ -120,7 +99,8 @@ concat_str (char ** str, const char * cat)
                 fprintf (stderr, "++ in concat_str(), newp is NULL\n");
             }
             free (*str);
-            *str = NULL;
+            *str         = NULL;
+            jls->str_len = 0;
             return -1;
         }
     }
@@ -142,7 +122,8 @@ concat_str (char ** str, const char * cat)
         }
     }
 
-    *str = newp;
+    *str         = newp;
+    jls->str_len = str_len + cat_len;
     if (JL_DBG)
     {
         fprintf (stderr, "++ in concat_str(), *str is %p\n", *str);
@@ -152,93 +133,143 @@ concat_str (char ** str, const char * cat)
 }
 
 int
-concat_char (char ** str, const char cat)
+concat_str (struct json_lex_state * jls, const char * cat)
+{
+    return concat_mem(jls, cat, strlen (cat));
+}
+
+int
+concat_char (struct json_lex_state * jls, const char cat)
 {
     char cat_str[2];
 
     cat_str[0] = cat;
     cat_str[1] = '\0';
 
-    return concat_str(str, cat_str);
+    return concat_str(jls, cat_str);
 }
 
+/* A \uXXXX escape is always decoded to UTF-8, whatever the codeset of
+ * the program, so the string reads back the same when it is escaped again.
+ */
 int
-concat_uni (char ** str, const char * json_utf8)
+concat_uni (struct json_lex_state * jls, const char * json_utf8)
 {
-    if (lex_ascii)
+    unsigned code;
+    int      ret;
+
+    ret = sscanf((json_utf8 + 2), "%4x", &code);
+
+    if (ret == 1)
     {
-        return concat_str(str, json_utf8);
+        if (JL_DBG)
+        {
+            fprintf(stderr, "[INF] extracted %04X from unicode hex characters \"%s\"\n", code, json_utf8);
+        }
     }
     else
     {
-        unsigned code;
-        int      ret;
+        fprintf(stderr, "[ERR] failed to extract unicode hex characters from \"%s\"\n", json_utf8);
+        return -1;
+    }
 
-        ret = sscanf((json_utf8 + 2), "%4x", &code);
+    if (code < 0x80ul)
+    {
+        char utf = 0;
+        ret = 0;
+        utf = (0x007Ful & code);
+        ret = ret | concat_char(jls, utf);
+        return ret;
+    }
+    else if (code < 0x800ul)
+    {
+        char utf = 0;
+        ret = 0;
+        utf = (0x0C0ul) | ((0x07C0ul & code) >> 6);
+        ret = ret | concat_char(jls, utf);
+        utf = 0x80ul | (0x003Ful & code);
+        ret = ret | concat_char(jls, utf);
+        return ret;
+    }
+    else
+    {
+        char utf = 0;
+        ret = 0;
+        utf = 0xE0ul | ((0xF000ul & code) >> 12);
+        ret = ret | concat_char(jls, utf);
+        utf = 0x80ul | ((0x0FC0ul & code) >> 6);
+        ret = ret | concat_char(jls, utf);
+        utf = 0x80ul | (0x003Ful & code);
+        ret = ret | concat_char(jls, utf);
+        return ret;
+    }
+}
 
-        if (ret == 1)
-        {
-            if (JL_DBG)
-            {
-                fprintf(stderr, "[INF] extracted %04X from unicode hex characters \"%s\"\n", code, json_utf8);
-            }
-        }
-        else
-        {
-            fprintf(stderr, "[ERR] failed to extract unicode hex characters from \"%s\"\n", json_utf8);
-            return -1;
-        }
+void
+posn_accum(struct json_lex_state * jls, int len)
+{
+    jls->lex_idx = jls->lex_idx + len;
+}
 
-        if (code < 0x80ul)
-        {
-            char utf = 0;
-            ret = 0;
-            utf = (0x007Ful & code);
-            ret = ret | concat_char(str, utf);
-            return ret;
-        }
-        else if (code < 0x800ul)
-        {
-            char utf = 0;
-            ret = 0;
-            utf = (0x0C0ul) | ((0x07C0ul & code) >> 6);
-            ret = ret | concat_char(str, utf);
-            utf = 0x80ul | (0x003Ful & code);
-            ret = ret | concat_char(str, utf);
-            return ret;
-        }
-        else if (code < 0x10000ul)
-        {
-            char utf = 0;
-            ret = 0;
-            utf = 0xE0ul | ((0xF000ul & code) >> 12);
-            ret = ret | concat_char(str, utf);
-            utf = 0x80ul | ((0x0FC0ul & code) >> 6);
-            ret = ret | concat_char(str, utf);
-            utf = 0x80ul | (0x003Ful & code);
-            ret = ret | concat_char(str, utf);
-            return ret;
-        }
-        else
-        {
-            return concat_str(str, json_utf8);
-        }
+/* Strings start out as a view of the source buffer, and are only copied
+ * into str_accum once the first escape sequence is seen.
+ */
+void
+str_bgn(struct json_lex_state * jls)
+{
+    jls->str_accum = NULL;
+    jls->str_len   = 0;
+    jls->str_bgn   = jls->lex_idx;
+    jls->str_esc   = 0;
+}
+
+void
+str_flush(struct json_lex_state * jls)
+{
+    if (jls->str_esc == 0)
+    {
+        concat_mem(jls, jls->lex_buffer + jls->str_bgn, jls->lex_idx - jls->str_bgn);
+        jls->str_esc = 1;
+    }
+}
+
+void
+str_end(struct json_lex_state * jls, struct json_lex_str * lstr)
+{
+    lstr->pos = jls->str_bgn - 1;
+
+    if (jls->str_esc == 0)
+    {
+        lstr->own = NULL;
+        lstr->off = jls->str_bgn;
+        lstr->len = jls->lex_idx - jls->str_bgn;
+    }
+    else
+    {
+        lstr->own = jls->str_accum;
+        lstr->off = 0;
+        lstr->len = jls->str_len;
     }
 }
 
 void
-posn_accum(const char * s)
+num_end(struct json_lex_state * jls, struct json_lex_str * lstr, int len)
 {
-    lex_idx = lex_idx + strlen(s);
+    lstr->own = NULL;
+    lstr->off = jls->lex_idx;
+    lstr->len = len;
+    lstr->pos = jls->lex_idx;
 }
 
-int yyerror(const char * s)
+int yyerror(yyscan_t scanner, struct json_lex_state * jls, const char * s)
 {
-    fprintf(stderr, "parser error: \"%s\" at character %d\n", s, lex_idx);
-    fprintf(stderr, "parser error: \'%s\'\n", lex_buffer);
+    (void) scanner;
+
+    fprintf(stderr, "parser error: \"%s\" at character %zu\n", s, jls->lex_idx);
+    fprintf(stderr, "parser error: \'%.*s\'\n", (int) jls->lex_buffer_len, jls->lex_buffer);
     fprintf(stderr, "parser error:  ");
 
-    for (int i = 0 ; i < (lex_idx - 1) ; i++)
+    for (size_t i = 1 ; i < jls->lex_idx ; i++)
     {
         fprintf(stderr, ".");
     }
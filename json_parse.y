@@ -29,39 +29,62 @@
 %output  "parser.c"
 %debug
 %error-verbose
+%define api.pure
+%lex-param   { yyscan_t scanner }
+%parse-param { yyscan_t scanner }
+%parse-param { struct json_lex_state * jls }
 
-%{
-    void            * cjv;
-    YY_BUFFER_STATE   cjb;
-%}
+%code requires {
+    #include <stddef.h>
+
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+        #define YY_TYPEDEF_YY_SCANNER_T
+        typedef void * yyscan_t;
+    #endif
+
+    struct json_lex_state;
+
+    /* A string or number value: either a malloc()ed string in own, or
+     * when own is NULL, len bytes of the source buffer starting at off.
+     * The token starts at source offset pos.
+     */
+    struct json_lex_str
+    {
+        char   * own;
+        size_t   off;
+        size_t   len;
+        size_t   pos;
+    };
+}
 
 %union {
-    int    ival;
-    char * sval;
+    int                 ival;
+    size_t              posn;
+    struct json_lex_str strv;
 }
 
 %token          END             0   "end of file"
-%token          begin_object
-%token          end_object
-%token          begin_array
-%token          end_array
+%token <posn>   begin_object
+%token <posn>   end_object
+%token <posn>   begin_array
+%token <posn>   end_array
 %token          comma
 %token          colon
-%token <sval>   string
-%token <sval>   number
-%token          null
-%token          yes
-%token          no
+%token <strv>   string
+%token <strv>   number
+%token <posn>   null
+%token <posn>   yes
+%token <posn>   no
 %start          json
 %%
 json:           object
                 | array
                 ;
-object:         begin_object   { c_set_obj_bgn(cjv); }         end_object { c_set_obj_end(cjv); }
-                | begin_object { c_set_obj_bgn(cjv); } members end_object { c_set_obj_end(cjv); }
+object:         begin_object   { c_set_obj_bgn(jls->cjv, $1); }         end_object { c_set_obj_end(jls->cjv, $3); }
+                | begin_object { c_set_obj_bgn(jls->cjv, $1); } members end_object { c_set_obj_end(jls->cjv, $4); }
                 ;
-array:          begin_array   { c_set_arr_bgn(cjv); }        end_array { c_set_arr_end(cjv); }
-                | begin_array { c_set_arr_bgn(cjv); } values end_array { c_set_arr_end(cjv); }
+array:          begin_array   { c_set_arr_bgn(jls->cjv, $1); }        end_array { c_set_arr_end(jls->cjv, $3); }
+                | begin_array { c_set_arr_bgn(jls->cjv, $1); } values end_array { c_set_arr_end(jls->cjv, $4); }
                 ;
 members:        member
                 | members comma member
@@ -69,36 +92,49 @@ members:        member
 values:         value
                 | values comma value
                 ;
-member:         string colon   { c_set_obj_key(cjv, $1); } object
-                | string colon { c_set_obj_key(cjv, $1); } array
-                | string colon number { c_set_obj_key(cjv, $1); c_set_elem_num(cjv, $3); }
-                | string colon string { c_set_obj_key(cjv, $1); c_set_elem_str(cjv, $3); }
-                | string colon null   { c_set_obj_key(cjv, $1); c_set_elem_nul(cjv);     }
-                | string colon yes    { c_set_obj_key(cjv, $1); c_set_elem_tru(cjv);     }
-                | string colon no     { c_set_obj_key(cjv, $1); c_set_elem_fal(cjv);     }
+member:         string colon   { c_set_obj_key(jls->cjv, $1.own, $1.off, $1.len, $1.pos); } object
+                | string colon { c_set_obj_key(jls->cjv, $1.own, $1.off, $1.len, $1.pos); } array
+                | string colon number { c_set_obj_key(jls->cjv, $1.own, $1.off, $1.len, $1.pos); c_set_elem_num(jls->cjv, $3.off, $3.len); }
+                | string colon string { c_set_obj_key(jls->cjv, $1.own, $1.off, $1.len, $1.pos); c_set_elem_str(jls->cjv, $3.own, $3.off, $3.len, $3.pos); }
+                | string colon null   { c_set_obj_key(jls->cjv, $1.own, $1.off, $1.len, $1.pos); c_set_elem_nul(jls->cjv, $3); }
+                | string colon yes    { c_set_obj_key(jls->cjv, $1.own, $1.off, $1.len, $1.pos); c_set_elem_tru(jls->cjv, $3); }
+                | string colon no     { c_set_obj_key(jls->cjv, $1.own, $1.off, $1.len, $1.pos); c_set_elem_fal(jls->cjv, $3); }
                 ;
 value:          object
                 | array
-                | number { c_set_elem_num(cjv, $1); }
-                | string { c_set_elem_str(cjv, $1); }
-                | null   { c_set_elem_nul(cjv);     }
-                | yes    { c_set_elem_tru(cjv);     }
-                | no     { c_set_elem_fal(cjv);     }
+                | number { c_set_elem_num(jls->cjv, $1.off, $1.len); }
+                | string { c_set_elem_str(jls->cjv, $1.own, $1.off, $1.len, $1.pos); }
+                | null   { c_set_elem_nul(jls->cjv, $1); }
+                | yes    { c_set_elem_tru(jls->cjv, $1); }
+                | no     { c_set_elem_fal(jls->cjv, $1); }
                 ;
 %%
-int json_parse(void * vec, char * str)
+int json_parse(void * vec, const char * str, size_t len)
 {
-    int ret;
+    struct json_lex_state jls;
+    yyscan_t              scanner;
+    YY_BUFFER_STATE       buf;
+    int                   ret;
+
+    jls.cjv            = vec;
+    jls.lex_start      = 1;
+    jls.lex_idx        = 0;
+    jls.str_bgn        = 0;
+    jls.str_esc        = 0;
+    jls.str_accum      = NULL;
+    jls.str_len        = 0;
+    jls.lex_buffer     = str;
+    jls.lex_buffer_len = len;
 
-    cjv        = vec;
-    lex_start  = 1;
-    lex_ascii  = 1;
-    lex_idx    = 0;
-    lex_buffer = str;
+    if (yylex_init_extra(&jls, &scanner))
+    {
+        return -1;
+    }
 
-    locale_codeset();
-    cjb = yy_scan_string(str);
-    ret = yyparse();
-    yy_delete_buffer(cjb);
+    /* the source need not be NUL terminated, flex takes its own copy */
+    buf = yy_scan_bytes(str, (yy_size_t) len, scanner);
+    ret = yyparse(scanner, &jls);
+    yy_delete_buffer(buf, scanner);
+    yylex_destroy(scanner);
     return ret;
 }
@@ -19,8 +19,21 @@
 
 // Unit test for SyscJson
 
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <locale.h>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
 #include <systemc.h>
 #include <SyscJson.h>
+#include <JsonVec.h>
 
 using namespace std;
 using namespace SyscMsg;
@@ -45,9 +58,71 @@ bool enable_test_14 = true;
 bool enable_test_15 = true;
 bool enable_test_16 = true;
 bool enable_test_17 = true;
+bool enable_test_18 = true;
+bool enable_test_19 = true;
+bool enable_test_20 = true;
+bool enable_test_21 = true;
+bool enable_test_22 = true;
+bool enable_test_23 = true;
+bool enable_test_24 = true;
+bool enable_test_25 = true;
+bool enable_test_26 = true;
+bool enable_test_27 = true;
+bool enable_test_28 = true;
+bool enable_test_29 = true;
+bool enable_test_30 = true;
+bool enable_test_31 = true;
+bool enable_test_32 = true;
+bool enable_test_33 = true;
+bool enable_test_34 = true;
+bool enable_test_35 = true;
+bool enable_test_36 = true;
+bool enable_test_37 = true;
+bool enable_test_38 = true;
+bool enable_test_39 = true;
+bool enable_test_40 = true;
 
 string path_parse_err_str = "catch while parsing JSON path";
 
+// heap allocations made by this program, for test[35]
+size_t alloc_count = 0;
+
+void * operator new(size_t arg_len)
+{
+    void * ptr = malloc((arg_len == 0) ? 1 : arg_len);
+
+    if (ptr == nullptr)
+    {
+        throw bad_alloc();
+    }
+
+    alloc_count++;
+    return ptr;
+}
+
+void operator delete(void * arg_ptr) noexcept
+{
+    free(arg_ptr);
+}
+
+// a locale with a decimal comma, or 0 if none is installed, for test[32] and test[39]
+locale_t comma_locale(void)
+{
+    locale_t loc = static_cast<locale_t>(0);
+
+    for (const char * name : { "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8", "de_DE", "fr_FR" })
+    {
+        loc = newlocale(LC_NUMERIC_MASK, name, static_cast<locale_t>(0));
+
+        if (loc != static_cast<locale_t>(0))
+        {
+            break;
+        }
+    }
+
+    return loc;
+}
+
 bool test_a_path(const string & arg_m, JsonFind & arg_c, string & arg_p, Token & arg_et, string & arg_es)
 {
     bool  ret  = true;
@@ -747,6 +822,1542 @@ int sc_main(int argc, char * argv[])
         pass = pass & ret;
     }
 
+    if (enable_test_18)
+    {
+        const int      nthr = 8;
+        vector<thread> thrs;
+        vector<int>    rets(nthr, 0);
+        string         src  = cstr.get_str();
+
+        for (int i = 0 ; i < nthr ; i++)
+        {
+            thrs.emplace_back([&rets, &src, i]()
+            {
+                JsonFind jfnd;
+                JsonStr  pstr;
+                string   tmp_str;
+
+                pstr.add_obj_bgn();
+                    pstr.add_key("num2");
+                    pstr.add_tru();
+                pstr.add_obj_end();
+
+                try
+                {
+                    for (int j = 0 ; j < 100 ; j++)
+                    {
+                        jfnd.set_search_context(src);
+                        jfnd.set_search_path(pstr.get_str());
+                        jfnd.find();
+                        jfnd.get_context_string(tmp_str);
+
+                        if (tmp_str != "-67")
+                        {
+                            return;
+                        }
+                    }
+                }
+                catch (JsonFindErr & err)
+                {
+                    return;
+                }
+
+                rets[i] = 1;
+            });
+        }
+
+        for (auto & thr : thrs)
+        {
+            thr.join();
+        }
+
+        bool ret = true;
+
+        for (int i = 0 ; i < nthr ; i++)
+        {
+            ret = ret && (rets[i] == 1);
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, concurrent parses in test[18]");
+        }
+        else
+        {
+            msg.cerr_err("fail, concurrent parses in test[18]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_19)
+    {
+        const array<JsonEngines, 3>    engns {{ json_engn_flex, json_engn_simd, json_engn_scal }};
+        const array<JsonTokenModes, 2> tmods {{ json_tmod_copy, json_tmod_view }};
+
+        bool   ret  = true;
+        string bad  = "{\"key1\":[1,2,],\"key2\":\"a\\\"b\"}";
+        string path = "{}";
+
+        for (JsonEngines engn : engns)
+        {
+            for (JsonTokenModes tmod : tmods)
+            {
+                JsonFind jfnd;
+                string   tmp_str;
+
+                jfnd.set_engine(engn);
+                jfnd.set_token_mode(tmod);
+
+                try
+                {
+                    jfnd.set_search_context(cstr.get_str());
+                    jfnd.set_search_path(path);
+                    jfnd.find();
+                    jfnd.get_context_string(tmp_str);
+                }
+                catch (JsonFindErr & err)
+                {
+                    msg.cerr_err(err.get_msg());
+                }
+
+                if (tmp_str != cstr.get_str())
+                {
+                    msg.cerr_err("fail, engine" + SP + to_string(engn) + SP + "mode" + SP + to_string(tmod) + SP + "returned unexpected string:" + SP + DQ + tmp_str + DQ);
+                    ret = false;
+                }
+
+                try
+                {
+                    jfnd.set_search_context(bad);
+                    msg.cerr_err("fail, engine" + SP + to_string(engn) + SP + "accepted malformed JSON");
+                    ret = false;
+                }
+                catch (JsonFindErr & err)
+                {
+                }
+            }
+        }
+
+        // keys, plain strings and numbers are views of the source, escaped
+        // strings are owned
+        for (JsonEngines engn : engns)
+        {
+            string               vstr("{\"key\":\"plain\",\"num\":-12.5,\"esc\":\"a\\\"b\"}");
+            JsonParse::JsonVec   jvec(vstr, engn, json_tmod_view);
+            Tokens               toks;
+            const vector<string> vtxt {{ "key", "plain", "num", "-12.5", "esc" }};
+
+            jvec.get_tape().get_tokens(toks);
+
+            for (size_t i = 0 ; i < vtxt.size() ; i++)
+            {
+                const Token & tok = toks[i + 1];
+
+                if ((!tok.has_elem_view()) || (!tok.element_str.empty()) || (string(tok.get_elem_ptr(), tok.get_elem_len()) != vtxt[i]))
+                {
+                    msg.cerr_err("fail, engine" + SP + to_string(engn) + SP + "did not give a view for" + SP + DQ + vtxt[i] + DQ);
+                    ret = false;
+                }
+            }
+
+            if ((toks[6].has_elem_view()) || (toks[6].element_str != "a\"b"))
+            {
+                msg.cerr_err("fail, engine" + SP + to_string(engn) + SP + "did not copy an escaped string");
+                ret = false;
+            }
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, parser engines and token modes agree in test[19]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_20)
+    {
+        bool   ret = true;
+        string src = cstr.get_str();
+
+        for (size_t chunk = 1 ; chunk <= 7 ; chunk++)
+        {
+            JsonPush jpsh;
+            JsonStr  jstr;
+            Tokens   part;
+            Tokens   tvec;
+
+            try
+            {
+                for (size_t i = 0 ; i < src.size() ; i += chunk)
+                {
+                    jpsh.put_chunk(src.data() + i, min(chunk, src.size() - i));
+                    jpsh.get_tokens(part);
+                    tvec.insert(tvec.end(), part.begin(), part.end());
+                }
+
+                jpsh.put_end();
+            }
+            catch (JsonPushErr & err)
+            {
+                msg.cerr_err(err.get_msg());
+            }
+
+            jstr.add_val(tvec);
+
+            if (jstr.get_str() != src)
+            {
+                msg.cerr_err("fail, chunk size" + SP + to_string(chunk) + SP + "returned unexpected string:" + SP + DQ + jstr.get_str() + DQ);
+                ret = false;
+            }
+        }
+
+        try
+        {
+            JsonPush jpsh;
+
+            jpsh.put_chunk("{\"key1\":[1,2");
+            jpsh.put_chunk(",]}");
+            msg.cerr_err("fail, push parser accepted malformed JSON");
+            ret = false;
+        }
+        catch (JsonPushErr & err)
+        {
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, push parser agrees for chunked input in test[20]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_21)
+    {
+        const array<JsonEngines, 3> engns {{ json_engn_flex, json_engn_simd, json_engn_scal }};
+
+        bool   ret    = true;
+        char   name[] = "test2_XXXXXX";
+        int    fd     = mkstemp(name);
+        string path   = "{}";
+        string src    = cstr.get_str();
+
+        if ((fd < 0) || (write(fd, src.data(), src.size()) != static_cast<ssize_t>(src.size())))
+        {
+            msg.cerr_err("fail, cannot write temporary file in test[21]");
+            ret = false;
+        }
+
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+
+        for (JsonEngines engn : engns)
+        {
+            JsonFind jfnd;
+            string   tmp_str;
+
+            jfnd.set_engine(engn);
+            jfnd.set_token_mode(json_tmod_view);
+
+            try
+            {
+                jfnd.set_search_context_file(name);
+                jfnd.set_search_path(path);
+                jfnd.find();
+                jfnd.get_context_string(tmp_str);
+            }
+            catch (JsonFindErr & err)
+            {
+                msg.cerr_err(err.get_msg());
+            }
+
+            if (tmp_str != src)
+            {
+                msg.cerr_err("fail, engine" + SP + to_string(engn) + SP + "returned unexpected string from file:" + SP + DQ + tmp_str + DQ);
+                ret = false;
+            }
+        }
+
+        unlink(name);
+
+        try
+        {
+            JsonFind jfnd;
+
+            jfnd.set_search_context_file(name);
+            msg.cerr_err("fail, missing file accepted in test[21]");
+            ret = false;
+        }
+        catch (JsonFindErr & err)
+        {
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, search context from file in test[21]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_22)
+    {
+        string   msgid(msg.get_str_r_msgid() + "test_a_path[" + "22" + "]:");
+        Token    etok(json_styp_elem, json_etyp_num, "5");
+        string   estr("5");
+        JsonStr  cstr_22;
+        JsonStr  pstr;
+        JsonFind jfnd;
+
+        cstr_22.add_arr_bgn();
+            cstr_22.add_obj_bgn();
+                cstr_22.add_key("key1");
+                cstr_22.add_num("1");
+            cstr_22.add_obj_end();
+            cstr_22.add_num("5");
+        cstr_22.add_arr_end();
+
+        pstr.add_arr_bgn();
+            pstr.add_num("1");
+            pstr.add_tru();
+        pstr.add_arr_end();
+
+        jfnd.set_search_context(cstr_22.get_str());
+
+        pass = pass & test_a_path(msgid, jfnd, pstr.get_str(), etok, estr);
+    }
+
+    if (enable_test_23)
+    {
+        bool           ret = true;
+        JsonStr        pstr;
+        vector<thread> thrs;
+        vector<string> rslt(4);
+
+        pstr.add_obj_bgn();
+            pstr.add_key("others");
+            pstr.add_arr_bgn();
+                pstr.add_num("6");
+                pstr.add_arr_bgn();
+                    pstr.add_num("3");
+                    pstr.add_arr_bgn();
+                        pstr.add_num("1");
+                        pstr.add_tru();
+                    pstr.add_arr_end();
+                pstr.add_arr_end();
+            pstr.add_arr_end();
+        pstr.add_obj_end();
+
+        const JsonPath path(pstr.get_str());
+
+        for (size_t i = 0 ; i < rslt.size() ; i++)
+        {
+            thrs.emplace_back([&cstr, &path, &rslt, i]()
+            {
+                JsonFind jfnd;
+
+                jfnd.set_token_mode((i & 1) ? json_tmod_view : json_tmod_copy);
+                jfnd.set_search_context(cstr.get_str());
+                jfnd.find(path);
+                jfnd.get_context_string(rslt[i]);
+            });
+        }
+
+        for (auto & thr : thrs)
+        {
+            thr.join();
+        }
+
+        for (string & r : rslt)
+        {
+            if (r != "val5")
+            {
+                msg.cerr_err("fail, shared JsonPath returned unexpected string:" + SP + DQ + r + DQ);
+                ret = false;
+            }
+        }
+
+        json->find(path);
+
+        if (!json->context_is_str())
+        {
+            msg.cerr_err("fail, JsonPath did not find a string in test[23]");
+            ret = false;
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, shared compiled search path in test[23]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_24)
+    {
+        const vector<string> pstrs
+        {
+            "{\"str1\":true}",
+            "{\"str1\":null}",
+            "{\"fakekey\":true}",
+            "{\"num2\":true}",
+            "{\"dat2\":{}}",
+            "{\"dat2\":{\"key1\":true}}",
+            "{\"others\":[5,{\"key2\":true}]}",
+            "{\"others\":[6,[3,[1,true]]]}",
+            "{\"others\":[6,[3,[7,true]]]}",
+            "{\"others\":[[0,true]]}",
+            "[0,true]"
+        };
+
+        bool               ret = true;
+        vector<JsonPath>   paths;
+        vector<JsonCursor> curs;
+        string             tmp_str;
+
+        for (const string & p : pstrs)
+        {
+            paths.emplace_back(p);
+        }
+
+        json->find(paths, curs);
+        curs[0].get_string(tmp_str);
+
+        if ((curs.size() != paths.size()) || (tmp_str != "dog"))
+        {
+            msg.cerr_err("fail, batch find() returned unexpected string for path:" + SP + pstrs[0]);
+            ret = false;
+        }
+
+        for (size_t i = 0 ; (ret) && (i < paths.size()) ; i++)
+        {
+            JsonCursor one;
+            Token      one_tok;
+            Token      cur_tok;
+            string     one_str;
+            string     cur_str;
+
+            json->find(paths[i]);
+            one = json->get_cursor();
+
+            if (one.is_none() != curs[i].is_none())
+            {
+                ret = false;
+            }
+            else if (one.is_none())
+            {
+                continue;
+            }
+            else
+            {
+                one.get_token(one_tok);
+                curs[i].get_token(cur_tok);
+                one.get_string(one_str);
+                curs[i].get_string(cur_str);
+
+                ret = (one_tok.struct_type == cur_tok.struct_type) && (one_tok.element_type == cur_tok.element_type) && (one_str == cur_str);
+
+                one.get_key(one_str);
+                curs[i].get_key(cur_str);
+
+                ret = ret && (one.has_key() == curs[i].has_key()) && (one_str == cur_str);
+            }
+
+            if (!ret)
+            {
+                msg.cerr_err("fail, batch find() disagrees with find() for path:" + SP + pstrs[i]);
+            }
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, batch find() agrees with find() in test[24]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_25)
+    {
+        bool     ret = true;
+        JsonStr  cstr_25;
+        JsonFind jfnd;
+
+        cstr_25.add_obj_bgn();
+            cstr_25.add_key("dup");
+            cstr_25.add_num("1");
+
+            for (size_t i = 0 ; i < 1000 ; i++)
+            {
+                string key_str("key" + to_string(i));
+                string num_str(to_string(i));
+
+                cstr_25.add_key(key_str);
+                cstr_25.add_num(num_str);
+            }
+
+            cstr_25.add_key("dup");
+            cstr_25.add_num("2");
+        cstr_25.add_obj_end();
+
+        jfnd.set_search_context(cstr_25.get_str());
+        jfnd.build_key_index(16);
+
+        for (size_t i = 0 ; (i < 1000) && ret ; i += 37)
+        {
+            string pstr("{\"key" + to_string(i) + "\":true}");
+            string tmp_str;
+
+            jfnd.set_search_path(pstr);
+            jfnd.find();
+            jfnd.get_context_string(tmp_str);
+
+            if (tmp_str != to_string(i))
+            {
+                msg.cerr_err("fail, indexed find() returned unexpected string for path:" + SP + pstr);
+                ret = false;
+            }
+        }
+
+        if (ret)
+        {
+            string dup_str("{\"dup\":true}");
+            string non_str("{\"nokey\":true}");
+            string tmp_str;
+
+            jfnd.set_search_path(dup_str);
+            jfnd.find();
+            jfnd.get_context_string(tmp_str);
+
+            jfnd.set_search_path(non_str);
+            jfnd.find();
+
+            if ((tmp_str != "1") || (!jfnd.context_is_none()))
+            {
+                msg.cerr_err("fail, indexed find() mishandled duplicate or missing key");
+                ret = false;
+            }
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, indexed find() in test[25]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_26)
+    {
+        bool     ret = true;
+        JsonStr  cstr_26;
+        JsonFind jfnd;
+
+        const vector<pair<string, string>> cases
+        {
+            { "[500,true]",   "500" },
+            { "[-1,true]",    "999" },
+            { "[-1000,true]", "0"   },
+            { "[-1001,true]", ""    },
+            { "[1000,true]",  ""    }
+        };
+
+        cstr_26.add_arr_bgn();
+
+        for (size_t i = 0 ; i < 1000 ; i++)
+        {
+            string num_str(to_string(i));
+
+            cstr_26.add_num(num_str);
+        }
+
+        cstr_26.add_arr_end();
+
+        jfnd.set_search_context(cstr_26.get_str());
+
+        for (size_t run = 0 ; (run < 2) && ret ; run++)
+        {
+            // the first pass walks the array, the second uses its index
+            if (run == 1)
+            {
+                jfnd.build_elem_index(16);
+            }
+
+            for (const pair<string, string> & c : cases)
+            {
+                string pstr(c.first);
+                string tmp_str;
+
+                jfnd.set_search_path(pstr);
+                jfnd.find();
+
+                if (!jfnd.context_is_none())
+                {
+                    jfnd.get_context_string(tmp_str);
+                }
+
+                if (tmp_str != c.second)
+                {
+                    msg.cerr_err("fail, find() by index returned unexpected string for path:" + SP + pstr);
+                    ret = false;
+                    break;
+                }
+            }
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, find() by index in test[26]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_27)
+    {
+        bool         ret  = true;
+        string       cstr_27("{ \"obj\" : { \"arr\" : [ 1, true ] },\n  \"esc\" : \"a\\\"b\" }");
+        string       opth("{\"obj\":{}}");
+        string       epth("{\"esc\":true}");
+        const char * ptr;
+        size_t       len;
+        JsonFind     jfnd;
+
+        jfnd.set_token_mode(json_tmod_view);
+        jfnd.set_search_context(cstr_27);
+
+        jfnd.set_search_path(opth);
+        jfnd.find();
+
+        if ((!jfnd.get_context_view(ptr, len)) || (string(ptr, len) != "{ \"arr\" : [ 1, true ] }"))
+        {
+            msg.cerr_err("fail, get_context_view() returned unexpected object text");
+            ret = false;
+        }
+
+        jfnd.set_search_path(epth);
+        jfnd.find();
+
+        if ((!jfnd.get_context_view(ptr, len)) || (string(ptr, len) != "a\\\"b"))
+        {
+            msg.cerr_err("fail, get_context_view() returned unexpected string text");
+            ret = false;
+        }
+
+        jfnd.set_token_mode(json_tmod_copy);
+        jfnd.set_search_context(cstr_27);
+        jfnd.find();
+
+        if (jfnd.get_context_view(ptr, len))
+        {
+            msg.cerr_err("fail, get_context_view() returned text in json_tmod_copy mode");
+            ret = false;
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, get_context_view() in test[27]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_28)
+    {
+        bool       ret = true;
+        string     cstr_28("{\"a\":{\"b\":[1,{\"c\":\"x\"},3]},\"d\":true}");
+        string     pstr("{\"a\":{\"b\":[]}}");
+        string     tmp_str;
+        string     key_str;
+        JsonFind   jfnd;
+        JsonCursor arr;
+        JsonCursor cur;
+
+        jfnd.set_search_context(cstr_28);
+        jfnd.set_search_path(pstr);
+        jfnd.find();
+
+        arr = jfnd.get_cursor();
+        arr.get_key(key_str);
+
+        if ((!arr.is_arr()) || (key_str != "b"))
+        {
+            msg.cerr_err("fail, get_cursor() returned unexpected cursor");
+            ret = false;
+        }
+
+        cur = arr.get_child().get_next();
+        cur.find(JsonPath("{\"c\":true}")).get_string(tmp_str);
+
+        if ((!cur.is_obj()) || (tmp_str != "x"))
+        {
+            msg.cerr_err("fail, cursor navigation returned unexpected string");
+            ret = false;
+        }
+
+        arr.find(JsonPath("[-1,true]")).get_string(tmp_str);
+
+        if ((tmp_str != "3") || (!arr.find(JsonPath("[-1,true]")).get_next().is_none()))
+        {
+            msg.cerr_err("fail, cursor find() returned unexpected array item");
+            ret = false;
+        }
+
+        cur = cur.get_parent().get_parent();
+        cur.get_key(key_str);
+
+        if ((!cur.is_obj()) || (key_str != "a") || (!cur.get_next().is_tru()))
+        {
+            msg.cerr_err("fail, get_parent() returned unexpected cursor");
+            ret = false;
+        }
+
+        cur = cur.get_parent();
+
+        if ((!cur.is_obj()) || (cur.has_key()) || (!cur.get_parent().is_none()) || (!jfnd.get_root().get_child().is_obj()))
+        {
+            msg.cerr_err("fail, cursor at top level is unexpected");
+            ret = false;
+        }
+
+        // a context key with an empty name still gives a cursor at its value
+        jfnd.set_search_context(cstr_28.replace(1, 3, "\"\""));
+        jfnd.find(JsonPath("{\"\":null}"));
+        cur = jfnd.get_cursor();
+
+        if ((!cur.is_obj()) || (!cur.has_key()))
+        {
+            msg.cerr_err("fail, get_cursor() at an empty key is unexpected");
+            ret = false;
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, cursor navigation in test[28]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_29)
+    {
+        bool                      ret = true;
+        shared_ptr<JsonDoc>       doc = make_shared<JsonDoc>();
+        vector<thread>            thrs;
+        vector<string>            rslt(4);
+        const JsonPath            path("{\"others\":[6,[3,[-2,true]]]}");
+
+        doc->set_token_mode(json_tmod_view);
+        doc->set_key_index(2);
+        doc->set_elem_index(2);
+        doc->parse(cstr.get_str());
+
+        shared_ptr<const JsonDoc> cdoc = doc;
+
+        for (size_t i = 0 ; i < rslt.size() ; i++)
+        {
+            thrs.emplace_back([&cdoc, &path, &rslt, i]()
+            {
+                JsonFind jfnd;
+
+                jfnd.set_search_context(cdoc);
+
+                for (size_t j = 0 ; j < 1000 ; j++)
+                {
+                    jfnd.find(path);
+                }
+
+                jfnd.get_context_string(rslt[i]);
+            });
+        }
+
+        for (auto & thr : thrs)
+        {
+            thr.join();
+        }
+
+        for (string & r : rslt)
+        {
+            if (r != "val5")
+            {
+                msg.cerr_err("fail, shared JsonDoc returned unexpected string:" + SP + DQ + r + DQ);
+                ret = false;
+            }
+        }
+
+        // index settings after sharing apply to a copy of the document,
+        // while a search of the shared tape runs on
+        {
+            shared_ptr<const JsonTape> held = cdoc->get_tape();
+            string                     hstr;
+            JsonFind                   hfnd;
+
+            hfnd.set_search_context(cdoc);
+
+            thread hthr([&hfnd, &path, &hstr]()
+            {
+                for (size_t j = 0 ; j < 1000 ; j++)
+                {
+                    hfnd.find(path);
+                }
+
+                hfnd.get_context_string(hstr);
+            });
+
+            doc->set_key_index(1);
+            doc->set_elem_index(1);
+            hthr.join();
+
+            if ((hstr != "val5") || (cdoc->get_tape() == held) || (!cdoc->get_tape()->has_key_index(0)))
+            {
+                msg.cerr_err("fail, JsonDoc index settings changed the shared tape");
+                ret = false;
+            }
+        }
+
+        try
+        {
+            JsonFind jfnd;
+
+            jfnd.set_search_context(shared_ptr<const JsonDoc>(nullptr));
+            msg.cerr_err("fail, set_search_context() accepted a null JsonDoc");
+            ret = false;
+        }
+        catch (JsonFindErr & err)
+        {
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, shared document in test[29]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_30)
+    {
+        bool       ret = true;
+        string     cstr_30("{\"hdr\":{\"ver\":\"1.2\",\"n\":4},\"body\":[1,2,} truncated");
+        string     cstr_ok("{\"hdr\":{\"ver\":\"1.2\"},\"body\":[]}");
+        string     pstr("{\"hdr\":{\"ver\":true}}");
+        string     mstr("{\"tail\":true}");
+        string     tmp_str;
+        JsonFind   jfnd;
+        JsonPush   jpsh;
+        Tokens     toks;
+
+        jfnd.set_search_path(pstr);
+        jfnd.find_stream(cstr_30);
+        jfnd.get_context_string(tmp_str);
+
+        if ((!jfnd.context_is_str()) || (tmp_str != "1.2"))
+        {
+            msg.cerr_err("fail, find_stream() returned unexpected string:" + SP + DQ + tmp_str + DQ);
+            ret = false;
+        }
+
+        jfnd.set_search_path(mstr);
+        jfnd.find_stream(cstr_ok);
+
+        if (!jfnd.context_is_none())
+        {
+            msg.cerr_err("fail, find_stream() found a missing key");
+            ret = false;
+        }
+
+        jpsh.set_search_path(JsonPath("{\"hdr\":null}"));
+
+        for (size_t i = 0 ; (i < cstr_30.size()) && (!jpsh.is_found()) ; i += 3)
+        {
+            jpsh.put_chunk(cstr_30.substr(i, 3));
+        }
+
+        jpsh.get_tokens(toks);
+
+        if ((!jpsh.is_found()) || (toks.size() != 9) || (toks[1].element_str != "hdr") || (toks[4].element_str != "1.2"))
+        {
+            msg.cerr_err("fail, JsonPush search returned unexpected tokens");
+            ret = false;
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, streaming search in test[30]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_31)
+    {
+        bool             ret = true;
+        string           cstr_31("{\"id\":7,\"blob\":[\"a\\u0041\",{\"x\":[1,2]},\"b\"],\"tags\":[\"t0\",{\"n\":1},\"t2\"]}");
+        string           tmp_str;
+        vector<JsonPath> paths;
+        JsonFind         jfnd;
+
+        paths.emplace_back("{\"id\":true}");
+        paths.emplace_back("{\"tags\":[2,true]}");
+
+        for (JsonEngines engn : { json_engn_flex, json_engn_simd, json_engn_scal })
+        {
+            jfnd.set_engine(engn);
+            jfnd.set_projection(paths);
+            jfnd.set_search_context(cstr_31);
+            jfnd.get_root().get_string(tmp_str);
+
+            if (tmp_str != "{\"id\":7,\"tags\":[null,{},\"t2\"]}")
+            {
+                msg.cerr_err("fail, projection kept unexpected tokens:" + SP + tmp_str);
+                ret = false;
+            }
+
+            jfnd.find(paths[1]);
+            jfnd.get_context_string(tmp_str);
+
+            if (tmp_str != "t2")
+            {
+                msg.cerr_err("fail, projection returned unexpected string:" + SP + DQ + tmp_str + DQ);
+                ret = false;
+            }
+        }
+
+        for (JsonEngines engn : { json_engn_flex, json_engn_simd, json_engn_scal })
+        {
+            string       cstr_view("[7,\"abcdef\",{\"q\":[1,2,3]},8]");
+            const char * view_ptr = nullptr;
+            size_t       view_len = 0;
+            JsonFind     jvew;
+
+            paths.clear();
+            paths.emplace_back("[0,true]");
+
+            jvew.set_engine(engn);
+            jvew.set_token_mode(json_tmod_view);
+            jvew.set_projection(paths);
+            jvew.set_search_context(cstr_view);
+
+            for (const char * path : { "[1,true]", "[2,true]", "[3,true]" })
+            {
+                jvew.find(JsonPath(path));
+
+                if (jvew.get_context_view(view_ptr, view_len))
+                {
+                    msg.cerr_err("fail, projection placeholder has a view at" + SP + path + ":" + SP + string(view_ptr, view_len));
+                    ret = false;
+                }
+            }
+
+            jvew.find(paths[0]);
+
+            if ((!jvew.get_context_view(view_ptr, view_len)) || (string(view_ptr, view_len) != "7"))
+            {
+                msg.cerr_err("fail, projection lost the view of a kept value");
+                ret = false;
+            }
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, projection in test[31]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_32)
+    {
+        bool     ret = true;
+        string   cstr_32("{\"i\":-9223372036854775808,\"u\":18446744073709551615,\"d\":2.5e-3,\"b\":false}");
+        string   ipth("{\"i\":true}");
+        string   upth("{\"u\":true}");
+        string   dpth("{\"d\":true}");
+        string   bpth("{\"b\":true}");
+        int64_t  ival = 0;
+        uint64_t uval = 0;
+        double   dval = 0;
+        bool     bval = true;
+        bool     thrw = false;
+        JsonFind jfnd;
+
+        jfnd.set_search_context(cstr_32);
+
+        jfnd.set_search_path(ipth);
+        jfnd.find();
+        jfnd.get_context_int64(ival);
+
+        jfnd.set_search_path(upth);
+        jfnd.find();
+        jfnd.get_context_uint64(uval);
+
+        jfnd.set_search_path(dpth);
+        jfnd.find();
+        jfnd.get_context_double(dval);
+
+        jfnd.set_search_path(bpth);
+        jfnd.find();
+        jfnd.get_context_bool(bval);
+
+        if ((ival != INT64_MIN) || (uval != UINT64_MAX) || (dval != 0.0025) || (bval))
+        {
+            msg.cerr_err("fail, typed accessors returned unexpected values");
+            ret = false;
+        }
+
+        try
+        {
+            jfnd.set_search_path(upth);
+            jfnd.find();
+            jfnd.get_context_int64(ival);
+        }
+        catch (JsonFindErr & err)
+        {
+            thrw = true;
+        }
+
+        if (!thrw)
+        {
+            msg.cerr_err("fail, get_context_int64() accepted an out of range number");
+            ret = false;
+        }
+
+        // numbers beyond the exact fast path do not follow the program's locale
+        if (locale_t loc = comma_locale())
+        {
+            string   lstr("[1.5e300,0.1234567890123456789012]");
+            string   lpth("[0,true]");
+            locale_t old = uselocale(loc);
+
+            jfnd.set_search_context(lstr);
+            jfnd.set_search_path(lpth);
+            jfnd.find();
+            jfnd.get_context_double(dval);
+
+            uselocale(old);
+            freelocale(loc);
+
+            if (dval != 1.5e300)
+            {
+                msg.cerr_err("fail, get_context_double() followed the locale:" + SP + to_string(dval));
+                ret = false;
+            }
+        }
+        else
+        {
+            msg.cerr_inf("no decimal comma locale installed, locale check skipped in test[32]");
+        }
+
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, typed accessors in test[32]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_33)
+    {
+        bool            ret = true;
+        string          cstr_33("{\"d\":[1.5,-2,12345678901234567,3e2],\"b\":[0,127,255],\"x\":[1,256]}");
+        string          dpth("{\"d\":true}");
+        string          bpth("{\"b\":true}");
+        string          xpth("{\"x\":true}");
+        vector<double>  dvec;
+        vector<int64_t> ivec;
+        vector<uint8_t> bvec;
+        bool            thrw = false;
+        JsonFind        jfnd;
+
+        jfnd.set_search_context(cstr_33);
+
+        jfnd.set_search_path(dpth);
+        jfnd.find();
+        jfnd.get_context_array(dvec);
+
+        jfnd.set_search_path(bpth);
+        jfnd.find();
+        jfnd.get_context_array(ivec);
+        jfnd.get_context_array(bvec);
+
+        if ((dvec != vector<double>{1.5, -2, 12345678901234567.0, 300}) || (ivec != vector<int64_t>{0, 127, 255}) || (bvec != vector<uint8_t>{0, 127, 255}))
+        {
+            msg.cerr_err("fail, get_context_array() returned unexpected values");
+            ret = false;
+        }
+
+        try
+        {
+            jfnd.set_search_path(xpth);
+            jfnd.find();
+            jfnd.get_context_array(bvec);
+        }
+        catch (JsonFindErr & err)
+        {
+            thrw = (err.get_msg().find("item 1") != string::npos) && (bvec.size() == 1);
+        }
+
+        if (!thrw)
+        {
+            msg.cerr_err("fail, get_context_array() did not report the out of range item");
+            ret = false;
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, bulk numeric arrays in test[33]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_34)
+    {
+        bool               ret = true;
+        string             cstr_34("{\"a/b\":{\"6\":\"six\",\"~k\":[10,[20,21],30]},\"01\":\"lead\"}");
+        string             tmp_str;
+        string             cur_str;
+        vector<JsonPath>   paths;
+        vector<JsonCursor> curs;
+        bool               thrw = false;
+        JsonFind           jfnd;
+
+        jfnd.set_search_context(cstr_34);
+
+        for (auto & tst : vector<pair<string, string>>{ {"/a~1b/6", "six"}, {"/a~1b/~0k/1/0", "20"}, {"/01", "lead"}, {"/a~1b/~0k/3", ""} })
+        {
+            jfnd.find_pointer(tst.first);
+            jfnd.get_context_string(tmp_str);
+
+            if (tmp_str != tst.second)
+            {
+                msg.cerr_err("fail, pointer" +SP+ tst.first +SP+ "found unexpected string:" + SP + DQ + tmp_str + DQ);
+                ret = false;
+            }
+        }
+
+        paths.emplace_back("/a~1b/~0k/2", json_psyn_ptr);
+        paths.emplace_back("/a~1b/6", json_psyn_ptr);
+        jfnd.find(paths, curs);
+        curs[0].get_string(tmp_str);
+        curs[1].get_string(cur_str);
+
+        if ((curs.size() != 2) || (tmp_str != "30") || (cur_str != "six"))
+        {
+            msg.cerr_err("fail, pointers found unexpected values");
+            ret = false;
+        }
+
+        try
+        {
+            jfnd.find_pointer("/a~2");
+        }
+        catch (JsonFindErr & err)
+        {
+            thrw = true;
+        }
+
+        if (!thrw)
+        {
+            msg.cerr_err("fail, find_pointer() accepted an invalid escape");
+            ret = false;
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, JSON Pointer in test[34]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_35)
+    {
+        bool     ret = true;
+        string   cstr_35("{\"a\":[1,{\"b\":\"x\",\"c\":-7}],\"d\":2.5}");
+        string   cpth("{\"a\":[1,{\"c\":true}]}");
+        JsonPath dpth("{\"d\":true}");
+        string   cptr("/a/1/c");
+        int64_t  ival = 0;
+        double   dval = 0;
+        size_t   hits = 0;
+        size_t   base;
+        JsonFind jfnd;
+
+        jfnd.set_search_context(cstr_35);
+        jfnd.set_search_path(cpth);
+        jfnd.find();
+        jfnd.find(dpth);
+        jfnd.find_pointer(cptr);
+
+        base = alloc_count;
+
+        for (int i = 0 ; i < 1000 ; i++)
+        {
+            jfnd.find();
+            hits += jfnd.context_is_num() ? 1 : 0;
+            jfnd.get_context_int64(ival);
+
+            jfnd.find(dpth);
+            hits += jfnd.context_is_str() ? 0 : 1;
+            jfnd.get_context_double(dval);
+
+            jfnd.find_pointer(cptr);
+            hits += jfnd.context_is_none() ? 0 : 1;
+        }
+
+        if ((alloc_count != base) || (hits != 3000) || (ival != -7) || (dval != 2.5))
+        {
+            msg.cerr_err("fail, repeated find() made" +SP+ to_string(alloc_count - base) +SP+ "allocations");
+            ret = false;
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, allocation-free find in test[35]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_36)
+    {
+        bool    ret = true;
+        string  snip("{\"s\":");
+        string  expt("{\"a\":[1,\"x\",null,{}],\"b\":[],\"c\":{\"s\":true},\"d\":false}");
+        JsonStr jstr;
+
+        jstr.add_nul();
+        jstr.rem_all();
+        jstr.add_obj_bgn();
+        jstr.add_key("a");
+        jstr.add_arr_bgn();
+        jstr.add_num("1");
+        jstr.add_str("x");
+        jstr.add_nul();
+        jstr.add_obj_bgn();
+        jstr.add_obj_end();
+        jstr.add_arr_end();
+        jstr.add_key("b");
+        jstr.add_arr_bgn();
+        jstr.add_arr_end();
+        jstr.add_key("c");
+        jstr.add_val(snip);
+        jstr.add_tru();
+        jstr.add_obj_end();
+        jstr.add_key("d");
+        jstr.add_fal();
+        jstr.add_obj_end();
+
+        if (jstr.get_str() != expt)
+        {
+            msg.cerr_err("fail, JsonStr returned unexpected string:" + SP + DQ + jstr.get_str() + DQ);
+            ret = false;
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, JsonStr comma state in test[36]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_37)
+    {
+        bool          ret   = true;
+        string        sent;
+        size_t        calls = 0;
+        ostringstream oss;
+        string        fstr(4096, ' ');
+        FILE        * file  = tmpfile();
+        JsonStr       mstr;
+
+        {
+            JsonStr cstr([&](const char * arg_ptr, size_t arg_len) { sent.append(arg_ptr, arg_len); calls++; });
+            JsonStr ostr(oss);
+            JsonStr dstr(fileno(file));
+
+            for (JsonStr * jstr : { &mstr, &cstr, &ostr, &dstr })
+            {
+                jstr->set_buffer(16);
+                jstr->add_arr_bgn();
+
+                for (int i = 0 ; i < 100 ; i++)
+                {
+                    jstr->add_obj_bgn();
+                    jstr->add_key("n");
+                    jstr->add_num(to_string(i).c_str());
+                    jstr->add_obj_end();
+                }
+
+                jstr->add_arr_end();
+            }
+
+            if (cstr.get_str().size() > 16 + 8)
+            {
+                msg.cerr_err("fail, JsonStr sink buffered" +SP+ to_string(cstr.get_str().size()) +SP+ "bytes");
+                ret = false;
+            }
+
+            cstr.flush();
+        }
+
+        rewind(file);
+        fstr.resize(fread(&fstr[0], 1, fstr.size(), file));
+        fclose(file);
+
+        if ((sent != mstr.get_str()) || (oss.str() != mstr.get_str()) || (fstr != mstr.get_str()) || (calls < 2))
+        {
+            msg.cerr_err("fail, JsonStr sinks wrote unexpected text:" + SP + DQ + sent + DQ);
+            ret = false;
+        }
+
+        // the final flush must not let a throwing sink out of the destructor
+        {
+            JsonStr tstr([](const char *, size_t) { throw runtime_error("sink closed"); });
+
+            tstr.add_arr_bgn();
+            tstr.add_arr_end();
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, JsonStr output sinks in test[37]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_38)
+    {
+        bool     ret = true;
+        string   clean(100, 'x');
+        string   ctrl("q\"b\\n\nt\tc\x01");
+        string   expt;
+        string   tmp_str;
+        JsonStr  jstr;
+        JsonStr  astr;
+        JsonFind jfnd;
+
+        clean[70] = '"';
+        jstr.add_obj_bgn();
+        jstr.add_key(ctrl);
+        jstr.add_str(clean);
+        jstr.add_obj_end();
+
+        expt = "{\"q\\\"b\\\\n\\nt\\tc\\u0001\":\"" + string(70, 'x') + "\\\"" + string(29, 'x') + "\"}";
+
+        if (jstr.get_str() != expt)
+        {
+            msg.cerr_err("fail, JsonStr escaped unexpectedly:" + SP + jstr.get_str());
+            ret = false;
+        }
+
+        jfnd.set_search_context(jstr.get_str());
+        jfnd.find_pointer("/" + ctrl);
+        jfnd.get_context_string(tmp_str);
+
+        if (tmp_str != clean)
+        {
+            msg.cerr_err("fail, escaped JsonStr did not parse back:" + SP + tmp_str);
+            ret = false;
+        }
+
+        astr.set_ascii(true);
+        astr.add_str("\xc3\xa9\xf0\x9f\x98\x80\xff.");
+
+        if (astr.get_str() != "\"\\u00e9\\ud83d\\ude00\\ufffd.\"")
+        {
+            msg.cerr_err("fail, JsonStr ASCII escapes unexpected:" + SP + astr.get_str());
+            ret = false;
+        }
+
+        // \u escapes decode to UTF-8 under an ASCII codeset too, so the
+        // parsers and the escaper round trip
+        {
+            string         ustr("{\"a\":[\"caf\\u00e9\",\"q\\\"x\"]}");
+            string         old_ctype(setlocale(LC_CTYPE, nullptr));
+            JsonPush       jpsh;
+            vector<Tokens> tvecs(4);
+
+            setlocale(LC_CTYPE, "C");
+
+            for (JsonEngines engn : { json_engn_flex, json_engn_simd, json_engn_scal })
+            {
+                JsonParse::JsonVec jvec(ustr, engn, json_tmod_copy);
+
+                jvec.get_tape().get_tokens(tvecs[engn]);
+            }
+
+            jpsh.put_chunk(ustr);
+            jpsh.put_end();
+            jpsh.get_tokens(tvecs[3]);
+
+            setlocale(LC_CTYPE, old_ctype.c_str());
+
+            for (size_t i = 0 ; i < tvecs.size() ; i++)
+            {
+                const Tokens & toks = tvecs[i];
+                JsonStr        uout;
+
+                if ((toks.size() < 4) || (string(toks[3].get_elem_ptr(), toks[3].get_elem_len()) != "caf\xc3\xa9"))
+                {
+                    msg.cerr_err("fail, \\u escape not decoded under the C codeset by parser" + SP + to_string(i));
+                    ret = false;
+                }
+
+                uout.set_ascii(true);
+                uout.add_val(tvecs[i]);
+
+                if (uout.get_str() != ustr)
+                {
+                    msg.cerr_err("fail, \\u escape did not round trip under the C codeset:" + SP + uout.get_str());
+                    ret = false;
+                }
+            }
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, JsonStr escaping in test[38]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_39)
+    {
+        bool     ret  = true;
+        string   expt("[-7,4000000000,-9223372036854775808,18446744073709551615,0.1,-1.5e-300,1e+21,0.000001,123456.789,null,-1,2,-3,4]");
+        double   dval = 0;
+        string   dptr("/4");
+        size_t   base;
+        JsonStr  jstr;
+        JsonFind jfnd;
+
+        base = alloc_count;
+
+        jstr.add_arr_bgn();
+        jstr.add_num(-7);
+        jstr.add_num(4000000000u);
+        jstr.add_num(INT64_MIN);
+        jstr.add_num(UINT64_MAX);
+        jstr.add_num(0.1);
+        jstr.add_num(-1.5e-300);
+        jstr.add_num(1e21);
+        jstr.add_num(0.000001);
+        jstr.add_num(123456.789);
+        jstr.add_num(HUGE_VAL);
+        jstr.add_num(-1LL);
+        jstr.add_num(2ULL);
+        jstr.add_num(static_cast<short>(-3));
+        jstr.add_num(4ul);
+        jstr.add_arr_end();
+
+        if ((jstr.get_str() != expt) || (alloc_count != base))
+        {
+            msg.cerr_err("fail, JsonStr numbers unexpected:" + SP + jstr.get_str());
+            ret = false;
+        }
+
+        jfnd.set_search_context(jstr.get_str());
+        jfnd.find_pointer(dptr);
+        jfnd.get_context_double(dval);
+
+        if (dval != 0.1)
+        {
+            msg.cerr_err("fail, JsonStr double did not read back");
+            ret = false;
+        }
+
+        if (locale_t loc = comma_locale())
+        {
+            JsonStr  lstr;
+            locale_t old = uselocale(loc);
+
+            lstr.add_arr_bgn();
+            lstr.add_num(1.5);
+            lstr.add_num(-2.5e-300);
+            lstr.add_arr_end();
+
+            uselocale(old);
+            freelocale(loc);
+
+            if (lstr.get_str() != "[1.5,-2.5e-300]")
+            {
+                msg.cerr_err("fail, JsonStr double followed the locale:" + SP + lstr.get_str());
+                ret = false;
+            }
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, JsonStr numbers in test[39]");
+        }
+
+        pass = pass & ret;
+    }
+
+    if (enable_test_40)
+    {
+        bool     ret  = true;
+        string   src("{\"a\":[1,{},[],{\"b\":\"q\\\"\\u00e9\\n\"}],\"c\":null,\"d\":{\"e\":[true,false,-2.5e3]}}");
+        string   expt("{\n  \"a\": [\n    1,\n    {},\n    [],\n    {\n      \"b\": \"q\\\"\\u00e9\\n\"\n    }\n  ],\n  \"c\": null,\n  \"d\": {\n    \"e\": [\n      true,\n      false,\n      -2.5e3\n    ]\n  }\n}");
+        JsonPush jpsh;
+        JsonStr  jcmp;
+        JsonStr  jpty;
+        Tokens   tvec;
+        size_t   base;
+
+        jpsh.put_chunk(src);
+        jpsh.put_end();
+        jpsh.get_tokens(tvec);
+
+        jcmp.set_ascii(true);
+        jpty.set_ascii(true);
+        jcmp.add_arr_bgn();
+        jcmp.add_num(0);
+
+        base = alloc_count;
+
+        jcmp.add_val(tvec);
+        jpty.add_val(tvec, 2);
+
+        if (alloc_count > base + 2)
+        {
+            msg.cerr_err("fail, serializer reallocated:" + SP + to_string(alloc_count - base));
+            ret = false;
+        }
+
+        jcmp.add_val(tvec);
+        jcmp.add_arr_end();
+
+        if (jcmp.get_str() != "[0," + src + "," + src + "]")
+        {
+            msg.cerr_err("fail, compact serializer returned:" + SP + jcmp.get_str());
+            ret = false;
+        }
+
+        if (jpty.get_str() != expt)
+        {
+            msg.cerr_err("fail, indented serializer returned:" + SP + jpty.get_str());
+            ret = false;
+        }
+
+        if (ret)
+        {
+            msg.cerr_inf("pass, token serializer in test[40]");
+        }
+
+        pass = pass & ret;
+    }
+
     if (pass)
     {
         msg.cerr_inf("pass");